@@ -39,6 +39,7 @@ class Predator : public cyclus::Facility  {
   virtual std::set<cyclus::RequestPortfolio<cyclus::Product>::Ptr>
       GetProductRequests();
 
+  using cyclus::Facility::AdjustProductPrefs;
   virtual void AdjustProductPrefs(cyclus::PrefMap<cyclus::Product>::type& prefs);
 
   /// @brief Predator place accepted trade Materials in their Inventory
@@ -18,6 +18,7 @@
 #endif // CYCLUS_IS_PARALLEL
 #include "cyclus.h"
 #include "hdf5_back.h"
+#include "mem_back.h"
 #include "pyhooks.h"
 #include "pyne.h"
 #include "query_backend.h"
@@ -134,7 +135,9 @@ int main(int argc, char* argv[]) {
 
   std::string ext = fs::path(ai.output_path).extension().string();
   std::string stem = fs::path(ai.output_path).stem().string();
-  if (ext == ".h5") {
+  if (ai.output_path == ":memory:") {
+    fback = new MemBack();
+  } else if (ext == ".h5") {
     fback = new Hdf5Back(ai.output_path.c_str());
   } else {
     fback = new SqliteBack(ai.output_path);
@@ -263,7 +266,8 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
 
   po::options_description file_options("File Options");
   file_options.add_options()
-      ("output-path,o", po::value<std::string>(), "output path")
+      ("output-path,o", po::value<std::string>(),
+       "output path, or :memory: to keep the output in memory")
       ("input-file,i", po::value<std::string>(),
        "input file, may be a path or a raw string")
       ("format,f", po::value<std::string>()->default_value("none"),
@@ -0,0 +1,168 @@
+// Replays exchange graphs captured with CYCLUS_DRE_CAPTURE through the
+// available exchange solvers and reports their run time and solution.
+#include "platform.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "error.h"
+#include "exchange_graph.h"
+#include "greedy_preconditioner.h"
+#include "greedy_solver.h"
+#include "prog_solver.h"
+
+using namespace cyclus;
+
+// a named recipe for a solver to benchmark. The graph is passed so that
+// preconditioners may look at its commodities.
+struct SolverCase {
+  std::string name;
+  ExchangeSolver* (*make)(const ExchangeGraph& g);
+};
+
+static std::map<std::string, double> CommodWeights(const ExchangeGraph& g) {
+  std::set<std::string> commods;
+  for (int i = 0; i < g.request_groups().size(); ++i) {
+    const std::vector<ExchangeNode::Ptr>& nodes =
+        g.request_groups()[i]->nodes();
+    for (int j = 0; j < nodes.size(); ++j) {
+      commods.insert(nodes[j]->commod);
+    }
+  }
+  // weigh commodities by name so that runs are reproducible
+  std::map<std::string, double> weights;
+  double w = commods.size();
+  for (std::set<std::string>::iterator it = commods.begin();
+       it != commods.end(); ++it) {
+    weights[*it] = w--;
+  }
+  return weights;
+}
+
+static ExchangeSolver* MakeGreedy(const ExchangeGraph& g) {
+  return new GreedySolver(false);
+}
+
+static ExchangeSolver* MakeGreedyNoCond(const ExchangeGraph& g) {
+  return new GreedySolver(false, NULL);
+}
+
+static ExchangeSolver* MakeGreedyCommod(const ExchangeGraph& g) {
+  return new GreedySolver(false, new GreedyPreconditioner(CommodWeights(g)));
+}
+
+static ExchangeSolver* MakeGreedyCommodRev(const ExchangeGraph& g) {
+  return new GreedySolver(
+      false, new GreedyPreconditioner(CommodWeights(g),
+                                      GreedyPreconditioner::REVERSE));
+}
+
+static ExchangeSolver* MakeGreedyExcl(const ExchangeGraph& g) {
+  return new GreedySolver(true);
+}
+
+#if CYCLUS_HAS_COIN
+static ExchangeSolver* MakeCbc(const ExchangeGraph& g) {
+  return new ProgSolver("cbc", false);
+}
+
+static ExchangeSolver* MakeClp(const ExchangeGraph& g) {
+  return new ProgSolver("clp", false);
+}
+#endif
+
+static ExchangeGraph::Ptr LoadGraph(const std::string& path) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  if (!in) {
+    throw IOError("could not open exchange graph file " + path);
+  }
+  return ReadGraph(in);
+}
+
+int main(int argc, char* argv[]) {
+  int reps = 1;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      std::cout << "Usage: cyclus_dre_bench [-n REPS] GRAPH [GRAPH ...]\n\n"
+                << "Replays exchange graphs written when running cyclus with "
+                << "CYCLUS_DRE_CAPTURE=<dir>\nthrough each exchange solver "
+                << "and reports the mean solve time (ms),\nobjective and "
+                << "matched quantity.\n";
+      return 0;
+    } else if (arg == "-n" && i + 1 < argc) {
+      reps = std::max(1, std::atoi(argv[++i]));
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty()) {
+    std::cerr << "cyclus_dre_bench: no graph files given, see --help\n";
+    return 1;
+  }
+
+  std::vector<SolverCase> cases;
+  cases.push_back(SolverCase{"greedy", &MakeGreedy});
+  cases.push_back(SolverCase{"greedy-nocond", &MakeGreedyNoCond});
+  cases.push_back(SolverCase{"greedy-commod", &MakeGreedyCommod});
+  cases.push_back(SolverCase{"greedy-commod-rev", &MakeGreedyCommodRev});
+  cases.push_back(SolverCase{"greedy-excl", &MakeGreedyExcl});
+#if CYCLUS_HAS_COIN
+  cases.push_back(SolverCase{"cbc", &MakeCbc});
+  cases.push_back(SolverCase{"clp", &MakeClp});
+#endif
+
+  std::cout << std::left << std::setw(32) << "graph" << std::setw(20)
+            << "solver" << std::right << std::setw(8) << "arcs"
+            << std::setw(12) << "time" << std::setw(16) << "objective"
+            << std::setw(16) << "matched" << "\n";
+  int status = 0;
+  for (int i = 0; i < paths.size(); ++i) {
+    for (int j = 0; j < cases.size(); ++j) {
+      try {
+        double elapsed = 0;
+        double obj = 0;
+        double matched = 0;
+        int n_arcs = 0;
+        for (int r = 0; r < reps; ++r) {
+          // solvers reorder the graph they are given, so every run gets a
+          // freshly read copy
+          ExchangeGraph::Ptr g = LoadGraph(paths[i]);
+          n_arcs = g->arcs().size();
+          ExchangeSolver* solver = cases[j].make(*g);
+          std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          obj = solver->Solve(g.get());
+          elapsed += std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+          delete solver;
+
+          matched = 0;
+          const std::vector<Match>& matches = g->matches();
+          for (int k = 0; k < matches.size(); ++k) {
+            matched += matches[k].second;
+          }
+        }
+        std::cout << std::left << std::setw(32) << paths[i] << std::setw(20)
+                  << cases[j].name << std::right << std::setw(8) << n_arcs
+                  << std::setw(12) << std::fixed << std::setprecision(3)
+                  << elapsed / reps << std::setw(16) << std::setprecision(6)
+                  << obj << std::setw(16) << matched << "\n";
+      } catch (Error& e) {
+        std::cerr << paths[i] << ": " << cases[j].name << ": " << e.what()
+                  << "\n";
+        status = 1;
+      }
+    }
+  }
+  return status;
+}
@@ -0,0 +1,118 @@
+// Runs a synthetic population of time listeners with skewed Tick costs, like
+// a few reactors among thousands of sinks, through each TickScheduler policy
+// and reports the time per time step.
+#include "platform.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#if CYCLUS_IS_PARALLEL
+#include <omp.h>
+#endif  // CYCLUS_IS_PARALLEL
+
+#include "tick_scheduler.h"
+#include "time_listener.h"
+
+using namespace cyclus;
+
+// spins for a fixed time on each tick
+class SpinListener : public TimeListener {
+ public:
+  SpinListener(int id, double us) : id_(id), us_(us) {}
+
+  virtual const int id() const { return id_; }
+  virtual bool IsShim() { return false; }
+
+  virtual void Tick() {
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::micro>(us_));
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+  virtual void Tock() {}
+
+ private:
+  int id_;
+  double us_;
+};
+
+int main(int argc, char* argv[]) {
+  int n_heavy = 8;
+  int n_light = 4000;
+  double heavy_us = 2000;
+  double light_us = 2;
+  int steps = 20;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      std::cout << "Usage: cyclus_tick_bench [--heavy N] [--light N] "
+                << "[--heavy-us US] [--light-us US] [-n STEPS]\n\n"
+                << "Ticks N heavy and N light listeners, spinning for the "
+                << "given microseconds\neach, for STEPS time steps with each "
+                << "tick schedule and reports the mean\ntime per step (ms). "
+                << "Heavy listeners are registered first.\n";
+      return 0;
+    } else if (arg == "--heavy" && i + 1 < argc) {
+      n_heavy = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--light" && i + 1 < argc) {
+      n_light = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--heavy-us" && i + 1 < argc) {
+      heavy_us = std::atof(argv[++i]);
+    } else if (arg == "--light-us" && i + 1 < argc) {
+      light_us = std::atof(argv[++i]);
+    } else if (arg == "-n" && i + 1 < argc) {
+      steps = std::max(1, std::atoi(argv[++i]));
+    } else {
+      std::cerr << "cyclus_tick_bench: unknown argument " << arg
+                << ", see --help\n";
+      return 1;
+    }
+  }
+
+  std::vector<SpinListener*> owned;
+  std::vector<TimeListener*> listeners;
+  for (int i = 0; i < n_heavy + n_light; ++i) {
+    owned.push_back(new SpinListener(i, i < n_heavy ? heavy_us : light_us));
+    listeners.push_back(owned.back());
+  }
+
+  int nthreads = 1;
+#if CYCLUS_IS_PARALLEL
+  nthreads = omp_get_max_threads();
+#endif  // CYCLUS_IS_PARALLEL
+  double total = n_heavy * heavy_us + n_light * light_us;
+  std::cout << "threads: " << nthreads << ", serial work per step: "
+            << std::fixed << std::setprecision(3) << total / 1000 << " ms\n";
+  std::cout << std::left << std::setw(12) << "schedule" << std::right
+            << std::setw(12) << "time" << std::setw(12) << "ideal"
+            << std::setw(12) << "efficiency" << "\n";
+
+  const char* names[] = {"static", "cost"};
+  for (int j = 0; j < 2; ++j) {
+    TickScheduler sched(TickScheduler::ParsePolicy(names[j]));
+    // the first step measures costs, so it is not timed
+    sched.Run(listeners, &TimeListener::Tick);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+      sched.Run(listeners, &TimeListener::Tick);
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start).count() /
+                     steps;
+    double ideal = std::max(total / nthreads, heavy_us) / 1000;
+    std::cout << std::left << std::setw(12) << names[j] << std::right
+              << std::setw(12) << elapsed << std::setw(12) << ideal
+              << std::setw(12) << ideal / elapsed << "\n";
+  }
+
+  for (int i = 0; i < owned.size(); ++i) {
+    delete owned[i];
+  }
+  return 0;
+}
@@ -152,6 +152,12 @@ def prepare_type(cpptype, othertype):
     else:
         return othertype
 
+def member_value(member, info):
+    """Returns the C++ expression for the value of a state variable member,
+    which is dereferenced if the member is a shared handle.
+    """
+    return '*' + member if info.get('shared', False) else member
+
 #
 # pass 1
 #
@@ -516,6 +522,11 @@ class VarDeclarationFilter(Filter):
         state.ensure_class_context(classname)
         annotations['type'] = state.canonize_type(vtype, vname,
                                                   statement=statement)
+        if annotations.get('shared', False):
+            t = annotations['type']
+            if (t if isinstance(t, STRING_TYPES) else t[0]) in BUFFERS:
+                msg = '{0}resource buffer {1!r} cannot be shared'
+                raise TypeError(msg.format(state.includeloc(statement), vname))
         annotations['index'] = len(state.context[classname]['vars'])
         annotations['shape'] = state.canonize_shape(annotations)
         state.context[classname]['vars'][vname] = annotations
@@ -540,11 +551,16 @@ class VarDeclarationFilter(Filter):
         classname = cg.classname()
         vtype, vname = self.match.groups()
         cg.var_annotations = None
-        shape = cg.context.get(classname, {}).get('vars', {})\
-                          .get(vname, {}).get('shape', None)
+        info = cg.context.get(classname, {}).get('vars', {}).get(vname, {})
+        s = statement
+        if info.get('shared', False):
+            # shared members are copy-on-write handles to the prototype's value
+            s = s.replace(vtype, '{0}::toolkit::Shared< {1} >'.format(
+                CYCNS, vtype), 1)
+        shape = info.get('shape', None)
         if shape is None:
-            return
-        s = statement + sep + '\n'
+            return None if s is statement else s + sep
+        s = s + sep + '\n'
         s += '  std::vector<int> cycpp_shape_{0};\n'.format(vname)
         return s
 
@@ -1653,7 +1669,8 @@ class InfileToDbFilter(CodeGeneratorFilter):
             if info['type'] in BUFFERS:
                 continue
             shape = ', &cycpp_shape_{0}'.format(member) if 'shape' in info else ''
-            impl += ind + '->AddVal("{0}", {0}{1})\n'.format(member, shape)
+            impl += ind + '->AddVal("{0}", {1}{2})\n'.format(
+                member, member_value(member, info), shape)
         impl += ind + '->Record();\n'
         return impl
 
@@ -1914,7 +1931,7 @@ class SnapshotFilter(CodeGeneratorFilter):
                     continue
                 expr = expr.format(var=member)
             else:
-                expr = member
+                expr = member_value(member, info)
 
             shape = ', &cycpp_shape_{0}'.format(member) if 'shape' in info else ''
             impl += ind + '->AddVal("{0}", {1}{2})\n'.format(member, expr, shape)
@@ -276,6 +276,7 @@ cdef extern from "pyhooks.h" namespace "cyclus::toolkit":
 
     cdef std_string PyToJson(std_string) except +
     cdef std_string JsonToPy(std_string) except +
+    cdef void PyAddTimeSeriesListener(std_string) except +
 
 
 cdef extern from "xml_file_loader.h" namespace "cyclus":
@@ -604,7 +605,7 @@ cdef extern from "bid_portfolio.h" namespace "cyclus":
         void AddConstraint(const CapacityConstraint[T]&)
         Trader* bidder()
         std_string commodity()
-        set[bid_ptr]& bids()
+        vector[bid_ptr]& bids()
         set[CapacityConstraint[T]]& constraints()
 
 
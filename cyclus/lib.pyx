@@ -1977,16 +1977,58 @@ def record_time_series(object tstype, object agent, object value):
             cpp_cyclus.RecordTimeSeriesEnrichFeed(a_ptr, value)
 
 
-TIME_SERIES_LISTENERS = defaultdict(list)
+class TimeSeriesListeners(defaultdict):
+    """Maps time series names to lists of listener functions. Cyclus only
+    hands the values of a time series to Python once the series has been
+    added here.
+    """
+
+    def __init__(self):
+        super().__init__(list)
+
+    def __missing__(self, key):
+        cpp_cyclus.PyAddTimeSeriesListener(str_py_to_cpp(key))
+        return super().__missing__(key)
+
+    def __setitem__(self, key, value):
+        cpp_cyclus.PyAddTimeSeriesListener(str_py_to_cpp(key))
+        super().__setitem__(key, value)
+
+    def setdefault(self, key, default=None):
+        cpp_cyclus.PyAddTimeSeriesListener(str_py_to_cpp(key))
+        return super().setdefault(key, default)
+
+    def update(self, *args, **kwargs):
+        d = dict(*args, **kwargs)
+        for key in d:
+            cpp_cyclus.PyAddTimeSeriesListener(str_py_to_cpp(key))
+        super().update(d)
+
+    def __ior__(self, other):
+        self.update(other)
+        return self
+
+
+TIME_SERIES_LISTENERS = TimeSeriesListeners()
 
 def call_listeners(tsname, agent, time, value):
     """Calls the time series listener functions of cyclus agents.
     """
-    vec = TIME_SERIES_LISTENERS[tsname]
+    vec = TIME_SERIES_LISTENERS.get(tsname, ())
     for f in vec:
         f(agent, time, value, tsname)
 
 
+def call_listeners_batch(tsname, agents, times, values):
+    """Calls the time series listener functions of cyclus agents with each of
+    the values of a time series recorded during a time step.
+    """
+    vec = TIME_SERIES_LISTENERS.get(tsname, ())
+    for agent, time, value in zip(agents, times, values):
+        for f in vec:
+            f(agent, time, value, tsname)
+
+
 EXT_BACKENDS = {'.h5': Hdf5Back, '.sqlite': SqliteBack}
 
 def dbopen(fname):
@@ -58,14 +58,18 @@ void Agent::Snapshot(DbInit di) {
 
 Agent::Agent(Context* ctx)
     : ctx_(ctx),
-      id_(next_id_++),
       kind_("Agent"),
       parent_id_(-1),
       enter_time_(-1),
       lifetime_(-1),
       parent_(NULL),
       spec_("UNSPECIFIED") {
-  ctx_->agent_list_.insert(this);
+  // agents may be cloned in parallel, see Context::CreateAgents
+#pragma omp critical(agent_ctor)
+  {
+    id_ = next_id_++;
+    ctx_->agent_list_.insert(this);
+  }
   MLOG(LEV_DEBUG3) << "Agent ID=" << id_ << ", ptr=" << this << " created.";
 }
 
@@ -48,6 +48,7 @@ typedef std::map<std::string, std::vector<Resource::Ptr>> Inventories;
 /// and #Snapshot functions must all write/read to/from the same database tables
 /// (and table schemas).
 class Agent : public StateWrangler, virtual public Ider, public EconomicEntity {
+  friend class Context;
   friend class SimInit;
   friend class ::SimInitTest;
 
@@ -322,10 +323,34 @@ class Agent : public StateWrangler, virtual public Ider, public EconomicEntity {
   /// END of their Decommission function.
   virtual void Decommission();
 
+  /// @brief default implementation for material preferences, which forwards
+  /// the preferences to the nested-map AdjustMatlPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustMatlPrefs(PrefMap<Material>& prefs) {
+    AdjustMatlPrefs(prefs.legacy());
+  }
+
+  /// @brief default implementation for product preferences, which forwards
+  /// the preferences to the nested-map AdjustProductPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustProductPrefs(PrefMap<Product>& prefs) {
+    AdjustProductPrefs(prefs.legacy());
+  }
+
   /// default implementation for material preferences.
+  /// @deprecated override AdjustMatlPrefs(PrefMap<Material>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Agent::AdjustMatlPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {}
 
-  /// default implementation for material preferences.
+  /// default implementation for product preferences.
+  /// @deprecated override AdjustProductPrefs(PrefMap<Product>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Agent::AdjustProductPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustProductPrefs(PrefMap<Product>::type& prefs) {}
 
   /// Returns an agent's xml rng schema for initializing from input files. All
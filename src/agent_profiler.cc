@@ -0,0 +1,142 @@
+#include "agent_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+#include "agent.h"
+#include "context.h"
+#include "env.h"
+
+namespace cyclus {
+
+const char* AgentProfiler::PhaseName(Phase p) {
+  switch (p) {
+    case TICK:
+      return "Tick";
+    case TOCK:
+      return "Tock";
+    case DECISION:
+      return "Decision";
+    case GET_MATL_REQUESTS:
+      return "GetMatlRequests";
+    case GET_MATL_BIDS:
+      return "GetMatlBids";
+    case GET_MATL_TRADES:
+      return "GetMatlTrades";
+    case ACCEPT_MATL_TRADES:
+      return "AcceptMatlTrades";
+    case GET_PRODUCT_REQUESTS:
+      return "GetProductRequests";
+    case GET_PRODUCT_BIDS:
+      return "GetProductBids";
+    case GET_PRODUCT_TRADES:
+      return "GetProductTrades";
+    case ACCEPT_PRODUCT_TRADES:
+      return "AcceptProductTrades";
+  }
+  return "";
+}
+
+int AgentProfiler::EnvInterval() {
+  std::string s = boost::to_lower_copy(Env::GetEnv("CYCLUS_PROFILE"));
+  if (s == "true" || s == "on" || s == "yes")
+    return 1;
+  // anything but a positive window length disables profiling
+  char* end = NULL;
+  long n = std::strtol(s.c_str(), &end, 10);
+  if (s.empty() || *end != '\0' || n <= 0)
+    return 0;
+  return static_cast<int>(std::min(n, static_cast<long>(INT_MAX)));
+}
+
+double AgentProfiler::Now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AgentProfiler::AgentProfiler(Context* ctx, int interval)
+    : ctx_(ctx), interval_(std::max(1, interval)), start_(-1), steps_(0) {}
+
+void AgentProfiler::Add(Agent* a, Phase p, double seconds) {
+  if (a == NULL)
+    return;  // not an agent, e.g. a listener in a test
+
+  int id = a->id();
+#pragma omp critical(agent_profiler)
+  {
+    Stat& s = window_[std::make_pair(id, static_cast<int>(p))];
+    ++s.calls;
+    s.seconds += seconds;
+    if (protos_.count(id) == 0)
+      protos_[id] = a->prototype();
+  }
+}
+
+void AgentProfiler::EndStep(int t) {
+  if (start_ < 0)
+    start_ = t;
+  if (++steps_ >= interval_)
+    Flush();
+}
+
+void AgentProfiler::Flush() {
+  std::map<std::pair<int, int>, Stat>::iterator it;
+  for (it = window_.begin(); it != window_.end(); ++it) {
+    int id = it->first.first;
+    Phase p = static_cast<Phase>(it->first.second);
+    ctx_->NewDatum("AgentProfile")
+        ->AddVal("AgentId", id)
+        ->AddVal("Phase", std::string(PhaseName(p)))
+        ->AddVal("Time", start_)
+        ->AddVal("Steps", steps_)
+        ->AddVal("Calls", it->second.calls)
+        ->AddVal("Seconds", it->second.seconds)
+        ->Record();
+
+    Stat& total = totals_[std::make_pair(protos_[id], it->first.second)];
+    total.calls += it->second.calls;
+    total.seconds += it->second.seconds;
+  }
+  window_.clear();
+  start_ = -1;
+  steps_ = 0;
+}
+
+/// Orders prototype totals by descending time.
+static bool MoreSeconds(const std::pair<double, std::pair<std::string, int> >& a,
+                        const std::pair<double, std::pair<std::string, int> >& b) {
+  return a.first > b.first;
+}
+
+void AgentProfiler::PrintSummary(std::ostream& os, int n) {
+  double all = 0;
+  std::vector<std::pair<double, std::pair<std::string, int> > > rows;
+  std::map<std::pair<std::string, int>, Stat>::iterator it;
+  for (it = totals_.begin(); it != totals_.end(); ++it) {
+    rows.push_back(std::make_pair(it->second.seconds, it->first));
+    all += it->second.seconds;
+  }
+  std::stable_sort(rows.begin(), rows.end(), MoreSeconds);
+
+  os << "Agent profile (" << std::fixed << std::setprecision(3) << all
+     << " s in agents):\n";
+  os << std::left << std::setw(32) << "prototype" << std::setw(24) << "phase"
+     << std::right << std::setw(12) << "calls" << std::setw(12) << "seconds"
+     << std::setw(8) << "%" << "\n";
+  for (int i = 0; i < rows.size() && i < n; ++i) {
+    Stat& s = totals_[rows[i].second];
+    os << std::left << std::setw(32) << rows[i].second.first << std::setw(24)
+       << PhaseName(static_cast<Phase>(rows[i].second.second)) << std::right
+       << std::setw(12) << s.calls << std::setw(12) << std::setprecision(3)
+       << s.seconds << std::setw(8) << std::setprecision(1)
+       << (all > 0 ? 100 * s.seconds / all : 0) << "\n";
+  }
+}
+
+}  // namespace cyclus
@@ -0,0 +1,124 @@
+#ifndef CYCLUS_SRC_AGENT_PROFILER_H_
+#define CYCLUS_SRC_AGENT_PROFILER_H_
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace cyclus {
+
+class Agent;
+class Context;
+class Material;
+class Product;
+
+/// Measures the wall time each agent spends in each phase of a time step.
+///
+/// Times are summed per agent and phase over a window of time steps, and each
+/// window is recorded to the AgentProfile table when it ends, with the
+/// columns AgentId, Phase, Time (the first time step of the window), Steps,
+/// Calls and Seconds. Totals per prototype are kept for the whole simulation
+/// and can be printed with PrintSummary.
+///
+/// Profiling is enabled by setting the CYCLUS_PROFILE environment variable to
+/// the number of time steps in a window, or to "true", "on" or "yes" for a
+/// window of one time step. Any other value, such as "0", "false" or "off",
+/// leaves profiling disabled. Code that measures a phase must not
+/// do any work besides checking for a NULL profiler when it is disabled.
+class AgentProfiler {
+ public:
+  /// The phases of a time step that are measured.
+  enum Phase {
+    TICK,
+    TOCK,
+    DECISION,
+    GET_MATL_REQUESTS,
+    GET_MATL_BIDS,
+    GET_MATL_TRADES,
+    ACCEPT_MATL_TRADES,
+    GET_PRODUCT_REQUESTS,
+    GET_PRODUCT_BIDS,
+    GET_PRODUCT_TRADES,
+    ACCEPT_PRODUCT_TRADES,
+  };
+
+  /// Returns the name of the agent method measured by phase, e.g. "Tick".
+  static const char* PhaseName(Phase p);
+
+  /// Returns the window length set by the CYCLUS_PROFILE environment
+  /// variable, or 0 if profiling is disabled.
+  static int EnvInterval();
+
+  /// Returns a steady clock time in seconds.
+  static double Now();
+
+  /// @param ctx the context that windows are recorded through
+  /// @param interval the number of time steps in a window
+  AgentProfiler(Context* ctx, int interval);
+
+  /// Adds the time an agent spent in a phase to the current window. This may
+  /// be called concurrently. Times of a NULL agent are ignored.
+  void Add(Agent* a, Phase p, double seconds);
+
+  /// Ends time step t and records the current window if it is complete.
+  void EndStep(int t);
+
+  /// Records the current window even if it is not complete.
+  void Flush();
+
+  /// Prints the total time of each prototype in each phase, most expensive
+  /// first.
+  ///
+  /// @param n the maximum number of lines printed
+  void PrintSummary(std::ostream& os, int n = 20);
+
+ private:
+  struct Stat {
+    Stat() : calls(0), seconds(0) {}
+    int calls;
+    double seconds;
+  };
+
+  Context* ctx_;
+  int interval_;
+
+  /// first time step of the current window and the number of steps in it
+  int start_;
+  int steps_;
+
+  // std::map<std::pair<AgentId, Phase>, Stat>
+  std::map<std::pair<int, int>, Stat> window_;
+
+  // std::map<AgentId, prototype>
+  std::map<int, std::string> protos_;
+
+  // std::map<std::pair<prototype, Phase>, Stat>
+  std::map<std::pair<std::string, int>, Stat> totals_;
+};
+
+/// The phases of a resource exchange of resource type T.
+template <class T> struct ExchangePhases;
+
+template <> struct ExchangePhases<Material> {
+  static const AgentProfiler::Phase kRequests =
+      AgentProfiler::GET_MATL_REQUESTS;
+  static const AgentProfiler::Phase kBids = AgentProfiler::GET_MATL_BIDS;
+  static const AgentProfiler::Phase kTrades = AgentProfiler::GET_MATL_TRADES;
+  static const AgentProfiler::Phase kAccept =
+      AgentProfiler::ACCEPT_MATL_TRADES;
+};
+
+template <> struct ExchangePhases<Product> {
+  static const AgentProfiler::Phase kRequests =
+      AgentProfiler::GET_PRODUCT_REQUESTS;
+  static const AgentProfiler::Phase kBids = AgentProfiler::GET_PRODUCT_BIDS;
+  static const AgentProfiler::Phase kTrades =
+      AgentProfiler::GET_PRODUCT_TRADES;
+  static const AgentProfiler::Phase kAccept =
+      AgentProfiler::ACCEPT_PRODUCT_TRADES;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_AGENT_PROFILER_H_
@@ -12,6 +12,75 @@ namespace cyclus {
 
 class Trader;
 template <class T> class BidPortfolio;
+template <class T> struct ExchangeContext;
+template <class T> class ExchangeArena;
+
+/// @class OfferSpec
+///
+/// @brief An OfferSpec describes the resource offered by a bid as a quantity
+/// and a (possibly shared) resource that the offer is like, e.g., a material
+/// with the composition being offered. The offered resource itself is only
+/// created if it is asked for, which normally only happens for bids that are
+/// traded. A bidder making many offers of the same composition can therefore
+/// share one resource among all of its bids, e.g.,
+///
+/// @code
+///
+/// Material::Ptr like = Material::CreateUntracked(0, comp);
+/// for (int i = 0; i < n; ++i) {
+///   port->AddBid(reqs[i], OfferSpec<Material>(qtys[i], like), this);
+/// }
+///
+/// @endcode
+///
+/// Deferred offers require the resource type to provide
+/// T::CreateUntracked(double, T::Ptr).
+template <class T> class OfferSpec {
+ public:
+  /// @brief describes an offer of qty of a resource like like, to be created
+  /// on demand
+  OfferSpec(double qty, boost::shared_ptr<T> like)
+      : qty_(qty), like_(like), create_(&OfferSpec<T>::CreateUntracked) {}
+
+  /// @brief describes an already existing offer
+  explicit OfferSpec(boost::shared_ptr<T> offer)
+      : qty_(offer->quantity()), like_(offer), offer_(offer), create_(NULL) {}
+
+  /// @return the quantity offered
+  inline double qty() const { return qty_; }
+
+  /// @return the resource the offer is like. For an existing offer, this is
+  /// the offer itself.
+  inline boost::shared_ptr<T> like() const { return like_; }
+
+  /// @return true if the offer is created on demand, in which case it is
+  /// unique to its bid even if like() is shared
+  inline bool deferred() const { return create_ != NULL; }
+
+  /// @return true if the offered resource exists
+  inline bool materialized() const { return offer_.get() != NULL; }
+
+  /// @return the offered resource, creating an untracked one on first use
+  boost::shared_ptr<T> offer() const {
+    if (offer_.get() == NULL) {
+      offer_ = create_(qty_, like_);
+    }
+    return offer_;
+  }
+
+ private:
+  typedef boost::shared_ptr<T> (*CreateFunc)(double, boost::shared_ptr<T>);
+
+  static boost::shared_ptr<T> CreateUntracked(double qty,
+                                              boost::shared_ptr<T> like) {
+    return T::CreateUntracked(qty, like);
+  }
+
+  double qty_;
+  boost::shared_ptr<T> like_;
+  mutable boost::shared_ptr<T> offer_;
+  CreateFunc create_;
+};
 
 /// @class Bid
 ///
@@ -38,6 +107,24 @@ template <class T> class Bid {
                                typename BidPortfolio<T>::Ptr portfolio,
                                bool exclusive,
                                double preference) {
+    return new Bid<T>(request, OfferSpec<T>(offer), bidder, portfolio,
+                      exclusive, preference);
+  }
+
+  /// @brief a factory method for a bid whose offer is created on demand
+  /// @param request the request being responded to by this bid
+  /// @param offer the description of the resource being offered
+  /// @param bidder the bidder
+  /// @param portfolio the porftolio of which this bid is a part
+  /// @param exclusive flag for whether the bid is exclusive
+  /// @param preference specifies the preference of a bid in a request
+  ///        to bid arc. If NaN the request preference is used.
+  inline static Bid<T>* Create(Request<T>* request,
+                               const OfferSpec<T>& offer,
+                               Trader* bidder,
+                               typename BidPortfolio<T>::Ptr portfolio,
+                               bool exclusive,
+                               double preference) {
     return new Bid<T>(request, offer, bidder, portfolio, exclusive, preference);
   }
 
@@ -63,7 +150,8 @@ template <class T> class Bid {
                                Trader* bidder, bool exclusive,
                                double preference,
                                Package::Ptr package = Package::unpackaged()) {
-    return new Bid<T>(request, offer, bidder, exclusive, preference, package);
+    return new Bid<T>(request, OfferSpec<T>(offer), bidder, exclusive,
+                      preference, package);
   }
   /// @brief a factory method for a bid for a bid without a portfolio
   /// @warning this factory should generally only be used for testing
@@ -77,8 +165,13 @@ template <class T> class Bid {
   /// @return the request being responded to
   inline Request<T>* request() const { return request_; }
 
-  /// @return the bid object for the request
-  inline boost::shared_ptr<T> offer() const { return offer_; }
+  /// @return the bid object for the request. If the offer was made with an
+  /// OfferSpec, it is created on the first call.
+  inline boost::shared_ptr<T> offer() const { return spec_.offer(); }
+
+  /// @return the description of the offer, which gives access to its quantity
+  /// and composition without creating it
+  inline const OfferSpec<T>& offer_spec() const { return spec_; }
 
   /// @return the agent responding the request
   inline Trader* bidder() const { return bidder_; }
@@ -92,56 +185,68 @@ template <class T> class Bid {
   /// @return the preference of this bid
   inline double preference() const { return preference_; }
 
+  /// @return the dense index assigned to this bid by the ExchangeContext it
+  /// was added to, or -1 if it has not been added to one
+  inline int id() const { return id_; }
+
  private:
+  friend struct ExchangeContext<T>;
+  friend class ExchangeArena<T>;
+
   /// @brief constructors are private to require use of factory methods
-  Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
+  Bid(Request<T>* request, const OfferSpec<T>& offer, Trader* bidder,
       bool exclusive, double preference,
       Package::Ptr package = Package::unpackaged())
       : request_(request),
-        offer_(offer),
+        spec_(offer),
         bidder_(bidder),
         exclusive_(exclusive),
         preference_(preference),
-        package_(package) {}
+        package_(package),
+        id_(-1) {}
   /// @brief constructors are private to require use of factory methods
-  Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
+  Bid(Request<T>* request, const OfferSpec<T>& offer, Trader* bidder,
       bool exclusive = false, Package::Ptr package = Package::unpackaged())
       : request_(request),
-        offer_(offer),
+        spec_(offer),
         bidder_(bidder),
         exclusive_(exclusive),
         preference_(std::numeric_limits<double>::quiet_NaN()),
-        package_(package) {}
+        package_(package),
+        id_(-1) {}
 
-  Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
+  Bid(Request<T>* request, const OfferSpec<T>& offer, Trader* bidder,
       typename BidPortfolio<T>::Ptr portfolio, bool exclusive,
       double preference, Package::Ptr package = Package::unpackaged())
       : request_(request),
-        offer_(offer),
+        spec_(offer),
         bidder_(bidder),
         portfolio_(portfolio),
         exclusive_(exclusive),
         preference_(preference),
-        package_(package) {}
+        package_(package),
+        id_(-1) {}
 
-  Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
+  Bid(Request<T>* request, const OfferSpec<T>& offer, Trader* bidder,
       typename BidPortfolio<T>::Ptr portfolio, bool exclusive = false,
       Package::Ptr package = Package::unpackaged())
       : request_(request),
-        offer_(offer),
+        spec_(offer),
         bidder_(bidder),
         portfolio_(portfolio),
         exclusive_(exclusive),
         preference_(std::numeric_limits<double>::quiet_NaN()),
-        package_(package) {}
+        package_(package),
+        id_(-1) {}
 
   Request<T>* request_;
-  boost::shared_ptr<T> offer_;
+  OfferSpec<T> spec_;
   Trader* bidder_;
   boost::weak_ptr<BidPortfolio<T>> portfolio_;
   bool exclusive_;
   double preference_;
   Package::Ptr package_;
+  int id_;
 };
 
 }  // namespace cyclus
@@ -4,12 +4,14 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
 #include "bid.h"
 #include "capacity_constraint.h"
 #include "error.h"
+#include "exchange_arena.h"
 
 namespace cyclus {
 
@@ -33,12 +35,16 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
  public:
   typedef boost::shared_ptr<BidPortfolio<T>> Ptr;
 
-  /// @brief default constructor
-  BidPortfolio() : bidder_(NULL) {}
+  /// @brief default constructor. If an ExchangeArena is active, bids added to
+  /// this portfolio are allocated from (and owned by) that arena.
+  BidPortfolio() : bidder_(NULL), arena_(ExchangeArena<T>::current()) {}
 
-  /// deletes all bids associated with it
+  /// deletes all bids associated with it, unless they are owned by an arena
   ~BidPortfolio() {
-    typename std::set<Bid<T>*>::iterator it;
+    if (arena_ != NULL) {
+      return;
+    }
+    typename std::vector<Bid<T>*>::iterator it;
     for (it = bids_.begin(); it != bids_.end(); ++it) {
       delete *it;
     }
@@ -55,15 +61,35 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// original
   Bid<T>* AddBid(Request<T>* request, boost::shared_ptr<T> offer,
                  Trader* bidder, bool exclusive, double preference) {
-    Bid<T>* b = Bid<T>::Create(request, offer, bidder, this->shared_from_this(),
-                               exclusive, preference);
+    return AddBid(request, OfferSpec<T>(offer), bidder, exclusive, preference);
+  }
+
+  /// @brief add a bid whose offer is only created if it is traded
+  /// @param request the request being responded to by this bid
+  /// @param offer the description of the resource being offered
+  /// @param bidder the bidder
+  /// @param exclusive indicates whether the bid is exclusive
+  /// @param preference sets the preference of the bid on a request
+  ///        bid arc.
+  /// @throws KeyError if a bid is added from a different bidder than the
+  /// original
+  Bid<T>* AddBid(Request<T>* request, const OfferSpec<T>& offer,
+                 Trader* bidder, bool exclusive, double preference) {
+    Bid<T>* b;
+    if (arena_ != NULL) {
+      b = arena_->NewBid(request, offer, bidder, this->shared_from_this(),
+                         exclusive, preference);
+    } else {
+      b = Bid<T>::Create(request, offer, bidder, this->shared_from_this(),
+                         exclusive, preference);
+    }
     VerifyResponder_(b);
-    if (offer->quantity() > 0)
-      bids_.insert(b);
+    if (offer.qty() > 0)
+      bids_.push_back(b);
     else {
       std::stringstream ss;
       ss << GetTraderPrototype(bidder) << " from " << GetTraderSpec(bidder)
-         << " is offering a bid quantity <= 0, Q = " << offer->quantity();
+         << " is offering a bid quantity <= 0, Q = " << offer.qty();
       throw ValueError(ss.str());
     }
     return b;
@@ -82,6 +108,19 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
                   std::numeric_limits<double>::quiet_NaN());
   }
 
+  /// @brief add a bid whose offer is only created if it is traded
+  /// @param request the request being responded to by this bid
+  /// @param offer the description of the resource being offered
+  /// @param bidder the bidder
+  /// @param exclusive indicates whether the bid is exclusive
+  /// @throws KeyError if a bid is added from a different bidder than the
+  /// original
+  Bid<T>* AddBid(Request<T>* request, const OfferSpec<T>& offer,
+                 Trader* bidder, bool exclusive = false) {
+    return AddBid(request, offer, bidder, exclusive,
+                  std::numeric_limits<double>::quiet_NaN());
+  }
+
   /// @brief add a capacity constraint associated with the portfolio
   /// @param c the constraint to add
   inline void AddConstraint(const CapacityConstraint<T>& c) {
@@ -95,8 +134,8 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// @return *deprecated* the commodity associated with the portfolio.
   inline std::string commodity() const { return ""; }
 
-  /// @return const access to the bids
-  inline const std::set<Bid<T>*>& bids() const { return bids_; }
+  /// @return const access to the bids, in the order they were added
+  inline const std::vector<Bid<T>*>& bids() const { return bids_; }
 
   /// @return the set of constraints over the bids
   inline const std::set<CapacityConstraint<T>>& constraints() const {
@@ -104,13 +143,23 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   }
 
  private:
+  friend class ExchangeArena<T>;
+
+  /// @brief keeps the storage of an ExchangeArena, and so this portfolio's
+  /// bids, alive for as long as this portfolio
+  void Keep(const boost::shared_ptr<void>& storage) {
+    if (kept_.empty() || kept_.back() != storage) {
+      kept_.push_back(storage);
+    }
+  }
+
   /// @brief copy constructor is private to prevent copying and preserve
   /// explicit single-ownership of bids
   BidPortfolio(const BidPortfolio& rhs) {
     bidder_ = rhs.bidder_;
     bids_ = rhs.bids_;
     constraints_ = rhs.constraints_;
-    typename std::set<Bid<T>*>::iterator it;
+    typename std::vector<Bid<T>*>::iterator it;
     for (it = bids_.begin(); it != bids_.end(); ++it) {
       it->get()->set_portfolio(this->shared_from_this());
     }
@@ -133,14 +182,22 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// @brief *deprecated*
   void VerifyCommodity_(const Bid<T>* r) {}
 
-  // bid_ is a set because there is a one-to-one correspondence between a
-  // bid and a request, i.e., bids are unique
-  std::set<Bid<T>*> bids_;
+  // bids_ is a vector so that bids are traversed in the order they were
+  // made, independent of where they were allocated. Bids are unique because
+  // each is created by AddBid.
+  std::vector<Bid<T>*> bids_;
 
   // constraints_ is a set because constraints are assumed to be unique
   std::set<CapacityConstraint<T>> constraints_;
 
   Trader* bidder_;
+
+  /// the arena owning this portfolio's bids, if any
+  ExchangeArena<T>* arena_;
+
+  /// arena storage kept alive for bids made in exchanges that this portfolio
+  /// has outlived
+  std::vector<boost::shared_ptr<void>> kept_;
 };
 
 }  // namespace cyclus
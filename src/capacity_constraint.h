@@ -3,6 +3,7 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include "bid.h"
 #include "error.h"
 #include "exchange_graph.h"
 #include "exchange_translation_context.h"
@@ -26,6 +27,17 @@ template <class T> struct Converter {
       Arc const* a = NULL,
       ExchangeTranslationContext<T> const* ctx = NULL) const = 0;
 
+  /// @brief convert a capacitated quantity for an offer described by spec.
+  /// The default creates the offer and calls convert(). Converters that only
+  /// need the offer's quantity or composition should override this so that
+  /// offers which are never traded are never created.
+  virtual double convert_offer(
+      const OfferSpec<T>& spec,
+      Arc const* a = NULL,
+      ExchangeTranslationContext<T> const* ctx = NULL) const {
+    return convert(spec.offer(), a, ctx);
+  }
+
   /// @brief operator== is available for subclassing, see
   /// cyclus::TrivialConverter for an example
   virtual bool operator==(Converter& other) const { return false; }
@@ -44,6 +56,14 @@ template <class T> struct TrivialConverter : public Converter<T> {
     return offer->quantity();
   }
 
+  /// @returns the quantity described by spec
+  inline virtual double convert_offer(
+      const OfferSpec<T>& spec,
+      Arc const* a = NULL,
+      ExchangeTranslationContext<T> const* ctx = NULL) const {
+    return spec.qty();
+  }
+
   /// @returns true if a dynamic cast succeeds
   virtual bool operator==(Converter<T>& other) const {
     return dynamic_cast<TrivialConverter<T>*>(&other) != NULL;
@@ -90,6 +110,12 @@ template <class T> class CapacityConstraint {
     return converter_->convert(offer, a, ctx);
   }
 
+  inline double convert(const OfferSpec<T>& spec,
+                        Arc const* a = NULL,
+                        ExchangeTranslationContext<T> const* ctx = NULL) const {
+    return converter_->convert_offer(spec, a, ctx);
+  }
+
   /// @return a unique id for the constraint
   inline int id() const { return id_; }
 
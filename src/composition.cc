@@ -75,17 +75,23 @@ const CompMap& Composition::mass() {
 
 Composition::Ptr Composition::Decay(int delta, uint64_t secs_per_timestep) {
   int tot_decay = prev_decay_ + delta;
-  if (decay_line_->count(tot_decay) == 1) {
-    // decay_line_ has cached, pre-computed result of this decay
-    return (*decay_line_)[tot_decay];
+  Composition::Ptr decayed;
+  // decay chains are shared between compositions that may be held by
+  // different agents, so lookups and insertions must not interleave
+#pragma omp critical(cyclus_decay_line)
+  {
+    if (decay_line_->count(tot_decay) == 1) {
+      // decay_line_ has cached, pre-computed result of this decay
+      decayed = (*decay_line_)[tot_decay];
+    } else {
+      // Calculate a new decayed composition and insert it into the decay
+      // chain. It will automagically appear in the decay chain for all other
+      // compositions that are a part of this decay chain because decay_line_
+      // is a pointer that all compositions in the chain share.
+      decayed = NewDecay(delta, secs_per_timestep);
+      (*decay_line_)[tot_decay] = decayed;
+    }
   }
-
-  // Calculate a new decayed composition and insert it into the decay chain.
-  // It will automagically appear in the decay chain for all other compositions
-  // that are a part of this decay chain because decay_line_ is a pointer that
-  // all compositions in the chain share.
-  Composition::Ptr decayed = NewDecay(delta, secs_per_timestep);
-  (*decay_line_)[tot_decay] = decayed;
   return decayed;
 }
 
@@ -112,15 +118,20 @@ void Composition::Record(Context* ctx) {
 }
 
 Composition::Composition() : prev_decay_(0), recorded_(false) {
-  id_ = next_id_;
-  next_id_++;
+  id_ = NextId();
   decay_line_ = ChainPtr(new Chain());
 }
 
 Composition::Composition(int prev_decay, ChainPtr decay_line)
     : recorded_(false), prev_decay_(prev_decay), decay_line_(decay_line) {
-  id_ = next_id_;
-  next_id_++;
+  id_ = NextId();
+}
+
+int Composition::NextId() {
+  int id;
+#pragma omp atomic capture
+  id = next_id_++;
+  return id;
 }
 
 std::string Composition::ToString(CompMap v) {
@@ -105,6 +105,9 @@ class Composition {
   /// Performs a decay calculation and creates a new decayed composition.
   Ptr NewDecay(int delta, uint64_t secs_per_timestep);
 
+  /// Returns the next unused composition id; safe to call concurrently.
+  static int NextId();
+
   static int next_id_;
   int id_;
   bool recorded_;
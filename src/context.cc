@@ -1,12 +1,15 @@
 #include "platform.h"
 #include "context.h"
 
+#include <algorithm>
+#include <exception>
 #include <vector>
 #include <boost/uuid/uuid_generators.hpp>
 #if CYCLUS_IS_PARALLEL
 #include <omp.h>
 #endif  // CYCLUS_IS_PARALLEL
 
+#include "dynamic_module.h"
 #include "error.h"
 #include "exchange_solver.h"
 #include "logger.h"
@@ -31,6 +34,10 @@ SimInfo::SimInfo()
       branch_time(-1),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_incremental(false),
+      snapshot_interval(0),
+      snapshot_incremental(false),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -46,6 +53,10 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_incremental(false),
+      snapshot_interval(0),
+      snapshot_incremental(false),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -61,6 +72,10 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle, std::string d)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_incremental(false),
+      snapshot_interval(0),
+      snapshot_incremental(false),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -78,6 +93,10 @@ SimInfo::SimInfo(int dur, boost::uuids::uuid parent_sim, int branch_time,
       branch_time(branch_time),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_incremental(false),
+      snapshot_interval(0),
+      snapshot_incremental(false),
       handle(handle),
       seed(kDefaultSeed),
       stride(kDefaultStride) {}
@@ -108,16 +127,146 @@ Context::~Context() {
   }
 }
 
+/// Returns whether an agent was made by a Python module.
+static bool IsPyAgent(Agent* a) {
+  try {
+    return DynamicModule::IsPyAgent(AgentSpec(a->spec()));
+  } catch (ValueError& e) {
+    return false;  // not made by a module, e.g. in tests
+  }
+}
+
+std::vector<Agent*> Context::CreateAgents(
+    const std::vector<std::string>& proto_names, bool parallel) {
+  int n = proto_names.size();
+  std::vector<Agent*> protos(n);
+  for (int i = 0; i < n; ++i) {
+    if (protos_.count(proto_names[i]) == 0) {
+      throw KeyError("Invalid prototype name " + proto_names[i]);
+    }
+    protos[i] = protos_[proto_names[i]];
+    if (protos[i] == NULL) {
+      throw KeyError("Null prototype for " + proto_names[i]);
+    }
+    // Python agents can only be cloned while holding the interpreter lock
+    if (parallel && IsPyAgent(protos[i])) {
+      parallel = false;
+    }
+  }
+
+  std::vector<Agent*> agents(n);
+  if (!parallel || n < 2) {
+    for (int i = 0; i < n; ++i) {
+      agents[i] = CreateAgent<Agent>(proto_names[i]);
+    }
+    return agents;
+  }
+
+  std::exception_ptr err;
+#pragma omp parallel for
+  for (int i = 0; i < n; ++i) {
+    try {
+      agents[i] = protos[i]->Clone();
+    } catch (...) {
+#pragma omp critical(create_agents)
+      err = std::current_exception();
+    }
+  }
+
+  std::vector<int> ids;
+  for (int i = 0; i < n; ++i) {
+    if (agents[i] != NULL) {
+      ids.push_back(agents[i]->id());
+    } else if (!err) {
+      err = std::make_exception_ptr(
+          StateError("Clone operation failed for " + proto_names[i]));
+    }
+  }
+  if (err) {
+    for (int i = 0; i < n; ++i) {
+      if (agents[i] != NULL) {
+        DelAgent(agents[i]);
+      }
+    }
+    std::rethrow_exception(err);
+  }
+
+  // agents got their ids in the order the threads created them, give them
+  // the ids they would have had if they were cloned one after the other
+  std::sort(ids.begin(), ids.end());
+  for (int i = 0; i < n; ++i) {
+    agents[i]->id_ = ids[i];
+  }
+  return agents;
+}
+
 void Context::DelAgent(Agent* m) {
   int n = agent_list_.erase(m);
   if (n == 1) {
+    // Python listeners are passed the agent of each buffered value
+    toolkit::PyFlushListeners();
     PyDelAgent(m->id());
     delete m;
     m = NULL;
   }
 }
 
+void Context::RegisterTrader(Trader* e) {
+  traders_.insert(e);
+  if (supplied_commods_.count(e) == 0) {
+    undeclared_traders_.insert(e);
+  }
+}
+
+void Context::UnregisterTrader(Trader* e) {
+  traders_.erase(e);
+  ClearSupplyCommods(e);
+  undeclared_traders_.erase(e);
+}
+
+void Context::SupplyCommods(Trader* e, const std::set<std::string>& commods) {
+  ClearSupplyCommods(e);
+  undeclared_traders_.erase(e);
+  supplied_commods_[e] = commods;
+  std::set<std::string>::const_iterator it;
+  for (it = commods.begin(); it != commods.end(); ++it) {
+    commod_suppliers_[*it].insert(e);
+  }
+}
+
+void Context::ClearSupplyCommods(Trader* e) {
+  std::map<Trader*, std::set<std::string>>::iterator it =
+      supplied_commods_.find(e);
+  if (it == supplied_commods_.end()) {
+    return;
+  }
+
+  std::set<std::string>::iterator cit;
+  for (cit = it->second.begin(); cit != it->second.end(); ++cit) {
+    std::set<Trader*>& suppliers = commod_suppliers_[*cit];
+    suppliers.erase(e);
+    if (suppliers.empty()) {
+      commod_suppliers_.erase(*cit);
+    }
+  }
+  supplied_commods_.erase(it);
+  if (traders_.count(e) > 0) {
+    undeclared_traders_.insert(e);
+  }
+}
+
+const std::set<Trader*>& Context::commod_suppliers(
+    const std::string& commod) const {
+  static const std::set<Trader*> none;
+  std::map<std::string, std::set<Trader*>>::const_iterator it =
+      commod_suppliers_.find(commod);
+  return it == commod_suppliers_.end() ? none : it->second;
+}
+
 void Context::SchedBuild(Agent* parent, std::string proto_name, int t) {
+  if (ti_->DeferBuild(parent, proto_name, t)) {
+    return;
+  }
 #pragma omp critical
   {
     if (t == -1) {
@@ -135,6 +284,9 @@ void Context::SchedBuild(Agent* parent, std::string proto_name, int t) {
 }
 
 void Context::SchedDecom(Agent* m, int t) {
+  if (ti_->DeferDecom(m, t)) {
+    return;
+  }
 #pragma omp critical
   {
     if (t == -1) {
@@ -292,6 +444,16 @@ void Context::InitSim(SimInfo si) {
       ->AddVal("RecordInventoryCompact", si.explicit_inventory_compact)
       ->Record();
 
+  NewDatum("InfoInventory")
+      ->AddVal("Interval", si.explicit_inventory_interval)
+      ->AddVal("Incremental", si.explicit_inventory_incremental)
+      ->Record();
+
+  NewDatum("InfoSnapshots")
+      ->AddVal("Interval", si.snapshot_interval)
+      ->AddVal("Incremental", si.snapshot_incremental)
+      ->Record();
+
   // TODO: when the backends get uint64_t support, the static_cast here should
   // be removed.
   NewDatum("TimeStepDur")
@@ -359,6 +521,18 @@ void Context::UnregisterTimeListener(TimeListener* tl) {
   ti_->UnregisterTimeListener(tl);
 }
 
+void Context::SleepUntil(Agent* a, int t) {
+  ti_->SleepUntil(a->id(), t);
+}
+
+void Context::Wake(Agent* a) {
+  ti_->Wake(a->id());
+}
+
+bool Context::IsAsleep(Agent* a) {
+  return a != NULL && ti_->IsAsleep(a->id());
+}
+
 Datum* Context::NewDatum(std::string title) {
   return rec_->NewDatum(title);
 }
@@ -375,4 +549,8 @@ bool Context::TimerIsQuiet() const {
   return ti_->IsQuiet();
 }
 
+AgentProfiler* Context::profiler() {
+  return ti_->profiler();
+}
+
 }  // namespace cyclus
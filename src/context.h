@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #ifndef CYCPP
@@ -42,6 +43,7 @@ class Datum;
 class ExchangeSolver;
 class Recorder;
 class Trader;
+class AgentProfiler;
 class Timer;
 class TimeListener;
 class SimInit;
@@ -126,6 +128,21 @@ class SimInfo {
   /// Composition-object and/or reference).
   bool explicit_inventory_compact;
 
+  /// Number of time steps between records of explicit inventories.
+  int explicit_inventory_interval;
+
+  /// True if explicit inventories are only recorded when their contents
+  /// changed since they were last recorded.
+  bool explicit_inventory_incremental;
+
+  /// Number of time steps between periodic snapshots of the simulation state,
+  /// or 0 for no periodic snapshots.
+  int snapshot_interval;
+
+  /// True if snapshots taken while the simulation runs only record the agents
+  /// whose state changed since the previous snapshot.
+  bool snapshot_incremental;
+
   /// Seed for random number generator
   uint64_t seed;
 
@@ -179,14 +196,35 @@ class Context {
 
   /// Registers an agent as a participant in resource exchanges. Agents should
   /// register from their Deploy method.
-  inline void RegisterTrader(Trader* e) { traders_.insert(e); }
+  void RegisterTrader(Trader* e);
 
-  /// Unregisters an agent as a participant in resource exchanges.
-  inline void UnregisterTrader(Trader* e) { traders_.erase(e); }
+  /// Unregisters an agent as a participant in resource exchanges. This also
+  /// forgets the commodities it declared with SupplyCommods.
+  void UnregisterTrader(Trader* e);
 
   /// @return the current set of traders registered for resource exchange.
   inline const std::set<Trader*>& traders() const { return traders_; }
 
+  /// Declares the commodities a trader can supply, replacing any commodities
+  /// it declared before. A trader that declared its commodities is only asked
+  /// for bids in exchanges with requests for at least one of them, while
+  /// other traders are asked for bids in every exchange. Traders should
+  /// declare their commodities again whenever they change.
+  void SupplyCommods(Trader* e, const std::set<std::string>& commods);
+
+  /// Forgets the commodities a trader declared, so that it is asked for bids
+  /// in every exchange again.
+  void ClearSupplyCommods(Trader* e);
+
+  /// @return the registered traders that have not declared the commodities
+  /// they supply.
+  inline const std::set<Trader*>& undeclared_traders() const {
+    return undeclared_traders_;
+  }
+
+  /// @return the traders that declared they supply the commodity.
+  const std::set<Trader*>& commod_suppliers(const std::string& commod) const;
+
   /// Create a new agent by cloning the named prototype. The returned agent is
   /// not initialized as a simulation participant.
   ///
@@ -214,6 +252,18 @@ class Context {
     return casted;
   }
 
+  /// Creates a new agent for each of the named prototypes, with the same ids
+  /// and in the same order as calling CreateAgent<Agent> for each name. The
+  /// returned agents are not initialized as simulation participants.
+  ///
+  /// If parallel is true, the prototypes are cloned in parallel unless any of
+  /// them is a Python agent. The Clone method of each prototype must then not
+  /// modify any state shared with other agents.
+  ///
+  /// @warning this method should generally NOT be used by agents.
+  std::vector<Agent*> CreateAgents(const std::vector<std::string>& proto_names,
+                                   bool parallel = false);
+
   /// Destructs and cleans up m (and it's children recursively).
   ///
   /// @warning this method should generally NOT be used by agents.
@@ -221,12 +271,15 @@ class Context {
 
   /// Schedules the named prototype to be built for the specified parent at
   /// timestep t. The default t=-1 results in the build being scheduled for the
-  /// next build phase (i.e. the start of the next timestep).
+  /// next build phase (i.e. the start of the next timestep). Builds scheduled
+  /// from a TimeListener::ParallelDecision are deferred until all concurrent
+  /// decisions are done.
   void SchedBuild(Agent* parent, std::string proto_name, int t = -1);
 
   /// Schedules the given Agent to be decommissioned at the specified timestep
   /// t. The default t=-1 results in the decommission being scheduled for the
   /// next decommission phase (i.e. the end of the current timestep).
+  /// Decommissionings are deferred like builds, see SchedBuild.
   void SchedDecom(Agent* m, int time = -1);
 
   /// Adds a composition recipe to a simulation-wide accessible list.
@@ -247,6 +300,23 @@ class Context {
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Puts an agent to sleep until the start of timestep t. A sleeping agent
+  /// receives no tick, tock or decision notifications and its traders are
+  /// not queried in resource exchanges, starting with the next phase of the
+  /// current timestep. Agents that have nothing to do for a while (e.g. a
+  /// reactor in the middle of a cycle) should sleep to save run time. An
+  /// agent is woken early if a child of it is built or decommissioned or if
+  /// Wake is called for it.
+  void SleepUntil(Agent* a, int t);
+
+  /// Wakes a sleeping agent, which is notified again starting with the next
+  /// phase of the current timestep. Waking an agent that is not asleep does
+  /// nothing.
+  void Wake(Agent* a);
+
+  /// Returns whether an agent is asleep.
+  bool IsAsleep(Agent* a);
+
   /// Initializes the simulation time parameters. Should only be called once -
   /// NOT idempotent.
   void InitSim(SimInfo si);
@@ -347,6 +417,9 @@ class Context {
   /// Returns whether the timer is in quiet mode
   bool TimerIsQuiet() const;
 
+  /// Returns the timer's agent profiler, or NULL if profiling is disabled.
+  AgentProfiler* profiler();
+
   /// @return the number of agents of a given prototype currently in the
   /// simulation
   inline int n_prototypes(std::string type) { return n_prototypes_[type]; }
@@ -381,6 +454,10 @@ class Context {
   std::map<std::string, TransportUnit::Ptr> transport_units_;
   std::set<Agent*> agent_list_;
   std::set<Trader*> traders_;
+  std::set<Trader*> undeclared_traders_;
+  // std::map<trader, supplied commodities> and its inverse
+  std::map<Trader*, std::set<std::string>> supplied_commods_;
+  std::map<std::string, std::set<Trader*>> commod_suppliers_;
   std::map<std::string, int> n_prototypes_;
   std::map<std::string, int> n_specs_;
 
@@ -75,6 +75,7 @@ extern "C" {
 #include "toolkit/res_buf.h"
 #include "toolkit/res_manip.h"
 #include "toolkit/res_map.h"
+#include "toolkit/shared.h"
 #include "toolkit/supply_demand_manager.h"
 #include "toolkit/symbolic_function_factories.h"
 #include "toolkit/symbolic_functions.h"
@@ -112,12 +112,12 @@ void DynamicModule::CloseAll() {
 }
 
 bool DynamicModule::IsPyAgent(AgentSpec spec) {
-  bool rtn = false;
-  if (DynamicModule::Exists(spec) &&
-      boost::starts_with(modules_[spec.str()]->path(), "<py>")) {
-    rtn = true;
-  }
-  return rtn;
+  // only loaded modules are looked up, which is cheap enough to do for every
+  // agent that is built
+  std::map<std::string, DynamicModule*>::iterator it =
+      modules_.find(spec.str());
+  return it != modules_.end() &&
+         boost::starts_with(it->second->path(), "<py>");
 }
 
 DynamicModule::DynamicModule(AgentSpec spec) : module_library_(0), ctor_(NULL) {
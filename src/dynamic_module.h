@@ -70,7 +70,7 @@ class DynamicModule {
   static void CloseAll();
 
   /// Tests that an agent spec is for a Python Agent. This will also return
-  /// false if the agent doesn't already exist.
+  /// false if the agent's module hasn't been loaded yet.
   static bool IsPyAgent(AgentSpec spec);
 
   /// The path to the module's shared object library.
@@ -75,6 +75,11 @@ class Env {
   /// location, set flat=true for the default flat schema.
   static const std::string rng_schema(bool flat = false);
 
+  /// @return the directory that generated master schemas are cached in, set
+  /// by the CYCLUS_SCHEMA_CACHE environment variable. Master schemas are not
+  /// cached if it is empty.
+  static const std::string schema_cache();
+
   /// @return the current value of the module environment variable
   /// CYCLUS_PATH
   static const std::vector<std::string> cyclus_path();
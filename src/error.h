@@ -124,12 +124,16 @@ template <Warnings T> void Warn(const std::string& msg) {
         throw Error(msg);
     }
   }
-  unsigned int cnt = warn_count[T]++;
-  if (cnt < warn_limit) {
-    std::cerr << warn_prefix[T] << ": " << msg << "\n";
-  } else if (cnt == 0) {
-  } else if (cnt == warn_limit) {
-    std::cerr << "Further " << warn_prefix[T] << "s will be suppressed.\n";
+  // agents may be constructed in parallel, see Context::CreateAgents
+#pragma omp critical(cyclus_warn)
+  {
+    unsigned int cnt = warn_count[T]++;
+    if (cnt < warn_limit) {
+      std::cerr << warn_prefix[T] << ": " << msg << "\n";
+    } else if (cnt == 0) {
+    } else if (cnt == warn_limit) {
+      std::cerr << "Further " << warn_prefix[T] << "s will be suppressed.\n";
+    }
   }
 }
 
@@ -0,0 +1,215 @@
+#ifndef CYCLUS_SRC_EXCHANGE_ARENA_H_
+#define CYCLUS_SRC_EXCHANGE_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace cyclus {
+
+template <class T> class Request;
+template <class T> class Bid;
+template <class T> class RequestPortfolio;
+template <class T> class BidPortfolio;
+
+/// @class ArenaPool
+///
+/// @brief A chunked pool of objects of a single type. Objects are constructed
+/// in place in fixed-size blocks and are all destroyed at once by Clear().
+/// Blocks are kept after a Clear() so that subsequent rounds do not need to
+/// go back to the heap.
+template <class U> class ArenaPool {
+ public:
+  explicit ArenaPool(size_t block_size = 1024)
+      : block_size_(block_size), n_(0) {}
+
+  ~ArenaPool() {
+    Clear();
+    for (int i = 0; i < blocks_.size(); ++i) {
+      ::operator delete(blocks_[i]);
+    }
+  }
+
+  /// @return uninitialized storage for the next object. The object is not
+  /// owned by the pool until Commit() is called, so a constructor that
+  /// throws leaves the pool unchanged.
+  void* Next() {
+    size_t b = n_ / block_size_;
+    if (b == blocks_.size()) {
+      blocks_.push_back(
+          static_cast<U*>(::operator new(block_size_ * sizeof(U))));
+    }
+    return blocks_[b] + n_ % block_size_;
+  }
+
+  /// @brief takes ownership of the object constructed at the last Next()
+  inline void Commit() { ++n_; }
+
+  /// @brief destroys all objects in the pool, most recent first
+  void Clear() {
+    while (n_ > 0) {
+      --n_;
+      (blocks_[n_ / block_size_] + n_ % block_size_)->~U();
+    }
+  }
+
+  /// @return the i-th live object in the pool, in order of construction
+  inline U* at(size_t i) {
+    return blocks_[i / block_size_] + i % block_size_;
+  }
+
+  /// @return the number of live objects in the pool
+  inline size_t size() const { return n_; }
+
+  /// @return the number of objects the pool can hold without allocating
+  inline size_t capacity() const { return blocks_.size() * block_size_; }
+
+ private:
+  ArenaPool(const ArenaPool&);
+  ArenaPool& operator=(const ArenaPool&);
+
+  std::vector<U*> blocks_;
+  size_t block_size_;
+  size_t n_;
+};
+
+/// @class ExchangeArena
+///
+/// @brief An ExchangeArena owns the requests and bids made during a single
+/// round of the Dynamic Resource Exchange and releases them all in one shot
+/// when the round is over.
+///
+/// An arena is made active for the duration of an exchange with a Scope.
+/// Request and bid portfolios created while an arena is active allocate their
+/// requests and bids from it rather than from the heap, e.g.,
+///
+/// @code
+///
+/// ExchangeArena<Material> arena;
+/// {
+///   ExchangeArena<Material>::Scope scope(&arena);
+///   // query traders, translate, solve, execute trades...
+/// }  // all requests and bids are destroyed here
+///
+/// @endcode
+///
+/// Requests and bids are normally only used while the arena's scope is alive.
+/// If a portfolio is still referenced when the scope ends, e.g., because an
+/// agent keeps it for a later phase, the arena's current storage is handed
+/// over to the surviving portfolios instead of being reused, so that their
+/// requests and bids stay valid for as long as the portfolios do.
+template <class T> class ExchangeArena {
+ public:
+  /// @class Scope
+  ///
+  /// @brief makes an arena the active arena for its lifetime, resetting it
+  /// and restoring the previously active arena on destruction
+  class Scope {
+   public:
+    explicit Scope(ExchangeArena<T>* arena)
+        : arena_(arena), prev_(ExchangeArena<T>::current_) {
+      ExchangeArena<T>::current_ = arena_;
+    }
+
+    ~Scope() {
+      ExchangeArena<T>::current_ = prev_;
+      arena_->Reset();
+    }
+
+   private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+
+    ExchangeArena<T>* arena_;
+    ExchangeArena<T>* prev_;
+  };
+
+  ExchangeArena() : pools_(new Pools()) {}
+
+  ~ExchangeArena() {
+    Reset();
+    if (current_ == this) {
+      current_ = NULL;
+    }
+  }
+
+  /// @return the active arena, or NULL if no exchange is in progress
+  inline static ExchangeArena<T>* current() { return current_; }
+
+  /// @brief constructs a new request in the arena, taking the same arguments
+  /// as the Request constructors
+  template <class... Args> Request<T>* NewRequest(Args&&... args) {
+    Request<T>* r =
+        new (pools_->requests.Next()) Request<T>(std::forward<Args>(args)...);
+    pools_->requests.Commit();
+    return r;
+  }
+
+  /// @brief constructs a new bid in the arena, taking the same arguments as
+  /// the Bid constructors
+  template <class... Args> Bid<T>* NewBid(Args&&... args) {
+    Bid<T>* b = new (pools_->bids.Next()) Bid<T>(std::forward<Args>(args)...);
+    pools_->bids.Commit();
+    return b;
+  }
+
+  /// @brief destroys all requests and bids in the arena, keeping its memory
+  /// for the next exchange. If any of their portfolios are still alive, the
+  /// storage is instead kept by those portfolios and the arena starts over
+  /// with new storage.
+  void Reset() {
+    bool kept = false;
+    Pools& p = *pools_;
+    for (size_t i = 0; i < p.requests.size(); ++i) {
+      boost::shared_ptr<RequestPortfolio<T>> port =
+          p.requests.at(i)->portfolio_.lock();
+      if (port) {
+        port->Keep(pools_);
+        kept = true;
+      }
+    }
+    for (size_t i = 0; i < p.bids.size(); ++i) {
+      boost::shared_ptr<BidPortfolio<T>> port = p.bids.at(i)->portfolio_.lock();
+      if (port) {
+        port->Keep(pools_);
+        kept = true;
+      }
+    }
+
+    if (kept) {
+      pools_.reset(new Pools());
+    } else {
+      p.bids.Clear();
+      p.requests.Clear();
+    }
+  }
+
+  /// @return the number of live requests in the arena
+  inline size_t n_requests() const { return pools_->requests.size(); }
+
+  /// @return the number of live bids in the arena
+  inline size_t n_bids() const { return pools_->bids.size(); }
+
+ private:
+  ExchangeArena(const ExchangeArena&);
+  ExchangeArena& operator=(const ExchangeArena&);
+
+  /// the storage of an arena, bids are destroyed before requests
+  struct Pools {
+    ArenaPool<Request<T>> requests;
+    ArenaPool<Bid<T>> bids;
+  };
+
+  static ExchangeArena<T>* current_;
+
+  boost::shared_ptr<Pools> pools_;
+};
+
+template <class T> ExchangeArena<T>* ExchangeArena<T>::current_ = NULL;
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_EXCHANGE_ARENA_H_
@@ -8,6 +8,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "bid.h"
 #include "bid_portfolio.h"
 #include "request.h"
@@ -20,10 +22,110 @@
 
 namespace cyclus {
 
-template <class T> struct PrefMap {
+/// @class PrefMap
+///
+/// @brief A PrefMap is a lightweight view of the request-bid preferences
+/// belonging to a single requester in an ExchangeContext.
+///
+/// Preferences are stored by the ExchangeContext in a contiguous array indexed
+/// by bid id. A PrefMap holds the ids of all bids made on a requester's
+/// requests and provides indexed access to each bid, its request, and a
+/// mutable reference to the arc preference, e.g.,
+///
+/// @code
+///
+/// void AdjustMatlPrefs(cyclus::PrefMap<cyclus::Material>& prefs) {
+///   for (int i = 0; i < prefs.size(); ++i) {
+///     if (prefs.bid(i)->bidder()->manager()->id() == banned_id_)
+///       prefs.pref(i) = -1;
+///   }
+/// }
+///
+/// @endcode
+///
+/// For backwards compatibility, the nested request -> bid -> preference map
+/// used by the original AdjustMatlPrefs/AdjustProductPrefs interface is still
+/// available as PrefMap<T>::type. It is built lazily by legacy() and any
+/// changes made to it are copied back into the preference array the next time
+/// the view is accessed or Sync() is called.
+template <class T> class PrefMap {
+ public:
   typedef std::map<Request<T>*, std::map<Bid<T>*, double>> type;
   typedef Request<T>* request_ptr;
   typedef Bid<T>* bid_ptr;
+
+  /// @param ids the ids of the bids in this view
+  /// @param bids all bids in the exchange, indexed by id
+  /// @param prefs all arc preferences in the exchange, indexed by bid id
+  PrefMap(const std::vector<int>& ids, const std::vector<Bid<T>*>& bids,
+          std::vector<double>& prefs)
+      : ids_(&ids), bids_(&bids), prefs_(&prefs) {}
+
+  /// @return the number of request-bid arcs in this view
+  inline int size() const { return ids_->size(); }
+
+  /// @return true if there are no request-bid arcs in this view
+  inline bool empty() const { return ids_->empty(); }
+
+  /// @return the exchange-wide id of the ith bid in this view
+  inline int id(int i) const { return (*ids_)[i]; }
+
+  /// @return the ith bid in this view
+  inline Bid<T>* bid(int i) const { return (*bids_)[(*ids_)[i]]; }
+
+  /// @return the request the ith bid in this view responds to
+  inline Request<T>* request(int i) const { return bid(i)->request(); }
+
+  /// @return a mutable reference to the preference of the ith arc
+  inline double& pref(int i) {
+    if (legacy_) Sync();
+    return (*prefs_)[(*ids_)[i]];
+  }
+
+  /// @return the preferences in this view as a nested request -> bid ->
+  /// preference map. The map is built once and kept until the view is next
+  /// accessed through pref() or Sync(), at which point any changes are written
+  /// back.
+  type& legacy() {
+    if (!legacy_) {
+      legacy_ = boost::shared_ptr<type>(new type());
+      for (int i = 0; i < size(); ++i) {
+        Bid<T>* b = bid(i);
+        (*legacy_)[b->request()][b] = (*prefs_)[id(i)];
+      }
+    }
+    return *legacy_;
+  }
+
+  /// @brief writes any changes made through legacy() back to the preference
+  /// array and releases the nested map. As with the original interface, an
+  /// arc whose entry was erased from the map is given a preference of 0, and
+  /// entries for bids that are not in this view are ignored.
+  void Sync() {
+    if (!legacy_) return;
+    for (int i = 0; i < size(); ++i) {
+      Bid<T>* b = bid(i);
+      double pref = 0;
+      typename type::const_iterator r = legacy_->find(b->request());
+      if (r != legacy_->end()) {
+        typename std::map<Bid<T>*, double>::const_iterator it =
+            r->second.find(b);
+        if (it != r->second.end()) {
+          pref = it->second;
+        }
+      }
+      (*prefs_)[id(i)] = pref;
+    }
+    legacy_.reset();
+  }
+
+ private:
+  const std::vector<int>* ids_;
+  const std::vector<Bid<T>*>* bids_;
+  std::vector<double>* prefs_;
+
+  /// lazily-built nested map
+  boost::shared_ptr<type> legacy_;
 };
 
 template <class T> struct CommodMap {
@@ -52,43 +154,83 @@ template <class T> struct ExchangeContext {
     typename std::vector<Request<T>*>::const_iterator it;
 
     for (it = vr.begin(); it != vr.end(); ++it) {
-      Request<T>* pr = *it;
       AddRequest(*it);
     }
   }
 
-  /// @brief Adds an individual request
+  /// @brief Adds an individual request, assigning it the next request id
   void AddRequest(Request<T>* pr) {
     assert(pr->requester() != NULL);
     requesters.insert(pr->requester());
     commod_requests[pr->commodity()].push_back(pr);
+
+    pr->id_ = requests_by_id.size();
+    requests_by_id.push_back(pr);
+    bids_by_request.push_back(std::vector<Bid<T>*>());
+
+    std::pair<std::map<Trader*, int>::iterator, bool> ins =
+        requester_idx_.insert(
+            std::make_pair(pr->requester(), (int)requester_bids_.size()));
+    if (ins.second) {
+      requester_bids_.push_back(std::vector<int>());
+    }
+    request_requester_.push_back(ins.first->second);
   }
 
   /// @brief adds a bid to the context
   void AddBidPortfolio(const typename BidPortfolio<T>::Ptr port) {
     bids.push_back(port);
-    const std::set<Bid<T>*>& vr = port->bids();
-    typename std::set<Bid<T>*>::const_iterator it;
+    const std::vector<Bid<T>*>& vr = port->bids();
+    typename std::vector<Bid<T>*>::const_iterator it;
 
     for (it = vr.begin(); it != vr.end(); ++it) {
-      Bid<T>* pb = *it;
-      AddBid(pb);
+      AddBid(*it);
     }
   }
 
-  /// @brief adds a bid to the appropriate containers, default trade preference
-  /// between request and bid is set
+  /// @brief adds a bid to the appropriate containers, assigning it the next
+  /// bid id, and sets the default trade preference between request and bid
   /// @param pb the bid
   void AddBid(Bid<T>* pb) {
     assert(pb->bidder() != NULL);
     bidders.insert(pb->bidder());
 
-    bids_by_request[pb->request()].push_back(pb);
+    Request<T>* pr = pb->request();
+    if (!HasRequest(pr)) {
+      AddRequest(pr);
+    }
+
+    pb->id_ = bids_by_id.size();
+    bids_by_id.push_back(pb);
+    bids_by_request[pr->id()].push_back(pb);
+    requester_bids_[request_requester_[pr->id()]].push_back(pb->id());
 
     double bid_pref = pb->preference();
-    trader_prefs[pb->request()->requester()][pb->request()].insert(
-        std::make_pair(
-            pb, std::isnan(bid_pref) ? pb->request()->preference() : bid_pref));
+    prefs.push_back(std::isnan(bid_pref) ? pr->preference() : bid_pref);
+  }
+
+  /// @return true if the request has been added to this context
+  inline bool HasRequest(Request<T>* pr) const {
+    return pr->id() >= 0 && pr->id() < (int)requests_by_id.size() &&
+           requests_by_id[pr->id()] == pr;
+  }
+
+  /// @return true if the bid has been added to this context
+  inline bool HasBid(Bid<T>* pb) const {
+    return pb->id() >= 0 && pb->id() < (int)bids_by_id.size() &&
+           bids_by_id[pb->id()] == pb;
+  }
+
+  /// @return a view of the preferences for all bids on a requester's
+  /// requests. The view is invalidated if any requests or bids are added to
+  /// the context.
+  PrefMap<T> trader_prefs(Trader* t) {
+    static const std::vector<int> kNoBids;
+    std::map<Trader*, int>::iterator it = requester_idx_.find(t);
+    if (it == requester_idx_.end()) {
+      return PrefMap<T>(kNoBids, bids_by_id, prefs);
+    }
+    return PrefMap<T>(requester_bids_[it->second], bids_by_id, prefs);
   }
 
   /// @brief a reference to an exchange's set of requests
@@ -106,11 +248,28 @@ template <class T> struct ExchangeContext {
   /// @brief maps commodity name to requests for that commodity
   typename CommodMap<T>::type commod_requests;
 
-  /// @brief maps request to all bids for request
-  std::map<Request<T>*, std::vector<Bid<T>*>> bids_by_request;
+  /// @brief all requests, indexed by request id
+  std::vector<Request<T>*> requests_by_id;
 
-  /// @brief maps commodity name to requests for that commodity
-  std::map<Trader*, typename PrefMap<T>::type> trader_prefs;
+  /// @brief all bids, indexed by bid id
+  std::vector<Bid<T>*> bids_by_id;
+
+  /// @brief all bids for each request, indexed by request id
+  std::vector<std::vector<Bid<T>*>> bids_by_request;
+
+  /// @brief the (possibly adjusted) preference of each request-bid arc,
+  /// indexed by bid id
+  std::vector<double> prefs;
+
+ private:
+  /// index of each requester into requester_bids_
+  std::map<Trader*, int> requester_idx_;
+
+  /// the ids of all bids on each requester's requests
+  std::vector<std::vector<int>> requester_bids_;
+
+  /// the requester index of each request, indexed by request id
+  std::vector<int> request_requester_;
 };
 
 }  // namespace cyclus
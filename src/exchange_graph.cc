@@ -1,6 +1,10 @@
 #include "exchange_graph.h"
 
 #include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdint.h>
 #include <boost/math/special_functions/next.hpp>
 
 #include "cyc_limits.h"
@@ -9,6 +13,113 @@
 
 namespace cyclus {
 
+// graph files start with a magic string and a format version, after which
+// all values are written in native byte order
+static const char kGraphMagic[4] = {'C', 'Y', 'X', 'G'};
+static const uint32_t kGraphVersion = 1;
+
+template <class T> static void WriteVal(std::ostream& out, T val) {
+  out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <class T> static T ReadVal(std::istream& in) {
+  T val;
+  in.read(reinterpret_cast<char*>(&val), sizeof(T));
+  if (!in) {
+    throw IOError("exchange graph file is truncated");
+  }
+  return val;
+}
+
+static void WriteDoubles(std::ostream& out, const std::vector<double>& vals) {
+  WriteVal<uint32_t>(out, vals.size());
+  if (!vals.empty()) {
+    out.write(reinterpret_cast<const char*>(&vals[0]),
+              vals.size() * sizeof(double));
+  }
+}
+
+static std::vector<double> ReadDoubles(std::istream& in) {
+  std::vector<double> vals(ReadVal<uint32_t>(in));
+  if (!vals.empty()) {
+    in.read(reinterpret_cast<char*>(&vals[0]), vals.size() * sizeof(double));
+    if (!in) {
+      throw IOError("exchange graph file is truncated");
+    }
+  }
+  return vals;
+}
+
+static void WriteGroup(std::ostream& out, const ExchangeNodeGroup& g,
+                       const std::map<std::string, uint32_t>& commods,
+                       std::map<ExchangeNode*, uint32_t>* node_ids) {
+  WriteDoubles(out, g.capacities());
+
+  const std::vector<ExchangeNode::Ptr>& nodes = g.nodes();
+  std::map<ExchangeNode*, uint32_t> local;
+  WriteVal<uint32_t>(out, nodes.size());
+  for (int i = 0; i < nodes.size(); ++i) {
+    ExchangeNode* n = nodes[i].get();
+    WriteVal<double>(out, n->qty);
+    WriteVal<uint8_t>(out, n->exclusive);
+    WriteVal<int32_t>(out, n->agent_id);
+    WriteVal<uint32_t>(out, commods.at(n->commod));
+    local[n] = i;
+    uint32_t id = node_ids->size();
+    (*node_ids)[n] = id;
+  }
+
+  const std::vector<std::vector<ExchangeNode::Ptr>>& excl =
+      g.excl_node_groups();
+  WriteVal<uint32_t>(out, excl.size());
+  for (int i = 0; i < excl.size(); ++i) {
+    WriteVal<uint32_t>(out, excl[i].size());
+    for (int j = 0; j < excl[i].size(); ++j) {
+      WriteVal<uint32_t>(out, local.at(excl[i][j].get()));
+    }
+  }
+}
+
+static void ReadGroup(std::istream& in, ExchangeNodeGroup* g,
+                      const std::vector<std::string>& commods,
+                      std::vector<ExchangeNode::Ptr>* nodes) {
+  std::vector<double> caps = ReadDoubles(in);
+  for (int i = 0; i < caps.size(); ++i) {
+    g->AddCapacity(caps[i]);
+  }
+
+  uint32_t n_nodes = ReadVal<uint32_t>(in);
+  for (uint32_t i = 0; i < n_nodes; ++i) {
+    double qty = ReadVal<double>(in);
+    bool exclusive = ReadVal<uint8_t>(in) != 0;
+    int agent_id = ReadVal<int32_t>(in);
+    uint32_t commod = ReadVal<uint32_t>(in);
+    if (commod >= commods.size()) {
+      throw IOError("exchange graph file has an invalid commodity index");
+    }
+    ExchangeNode::Ptr n(
+        new ExchangeNode(qty, exclusive, commods[commod], agent_id));
+    // exclusive groups are read explicitly below, so bypass any group
+    // specific bookkeeping
+    g->ExchangeNodeGroup::AddExchangeNode(n);
+    nodes->push_back(n);
+  }
+
+  const std::vector<ExchangeNode::Ptr>& local = g->nodes();
+  uint32_t n_excl = ReadVal<uint32_t>(in);
+  for (uint32_t i = 0; i < n_excl; ++i) {
+    std::vector<ExchangeNode::Ptr> excl(ReadVal<uint32_t>(in));
+    for (int j = 0; j < excl.size(); ++j) {
+      uint32_t idx = ReadVal<uint32_t>(in);
+      if (idx >= local.size()) {
+        throw IOError("exchange graph file has an invalid node index");
+      }
+      excl[j] = local[idx];
+    }
+    g->AddExclGroup(excl);
+  }
+}
+
 ExchangeNode::ExchangeNode(double qty, bool exclusive, std::string commod,
                            int agent_id)
     : qty(qty),
@@ -128,4 +239,142 @@ void ExchangeGraph::AddMatch(const Arc& a, double qty) {
   matches_.push_back(std::make_pair(a, qty));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WriteGraph(const ExchangeGraph& g, std::ostream& out) {
+  out.write(kGraphMagic, sizeof(kGraphMagic));
+  WriteVal<uint32_t>(out, kGraphVersion);
+
+  // commodity names are written once and referred to by index
+  std::vector<ExchangeNodeGroup*> groups;
+  for (int i = 0; i < g.request_groups().size(); ++i) {
+    groups.push_back(g.request_groups()[i].get());
+  }
+  for (int i = 0; i < g.supply_groups().size(); ++i) {
+    groups.push_back(g.supply_groups()[i].get());
+  }
+  std::map<std::string, uint32_t> commods;
+  std::vector<std::string> commod_names;
+  for (int i = 0; i < groups.size(); ++i) {
+    const std::vector<ExchangeNode::Ptr>& nodes = groups[i]->nodes();
+    for (int j = 0; j < nodes.size(); ++j) {
+      if (commods.insert(std::make_pair(nodes[j]->commod,
+                                        commod_names.size())).second) {
+        commod_names.push_back(nodes[j]->commod);
+      }
+    }
+  }
+  WriteVal<uint32_t>(out, commod_names.size());
+  for (int i = 0; i < commod_names.size(); ++i) {
+    WriteVal<uint32_t>(out, commod_names[i].size());
+    out.write(commod_names[i].data(), commod_names[i].size());
+  }
+
+  // nodes are numbered in the order they are written, requests first
+  std::map<ExchangeNode*, uint32_t> node_ids;
+  WriteVal<uint32_t>(out, g.request_groups().size());
+  for (int i = 0; i < g.request_groups().size(); ++i) {
+    RequestGroup::Ptr rg = g.request_groups()[i];
+    WriteVal<double>(out, rg->qty());
+    WriteGroup(out, *rg, commods, &node_ids);
+  }
+  WriteVal<uint32_t>(out, g.supply_groups().size());
+  for (int i = 0; i < g.supply_groups().size(); ++i) {
+    WriteGroup(out, *g.supply_groups()[i], commods, &node_ids);
+  }
+
+  const std::vector<Arc>& arcs = g.arcs();
+  WriteVal<uint32_t>(out, arcs.size());
+  for (int i = 0; i < arcs.size(); ++i) {
+    const Arc& a = arcs[i];
+    ExchangeNode::Ptr u = a.unode();
+    ExchangeNode::Ptr v = a.vnode();
+    WriteVal<uint32_t>(out, node_ids.at(u.get()));
+    WriteVal<uint32_t>(out, node_ids.at(v.get()));
+    WriteVal<double>(out, a.pref());
+
+    std::map<Arc, double>::const_iterator upref = u->prefs.find(a);
+    std::map<Arc, double>::const_iterator vpref = v->prefs.find(a);
+    uint8_t flags = (upref != u->prefs.end() ? 1 : 0) |
+                    (vpref != v->prefs.end() ? 2 : 0);
+    WriteVal<uint8_t>(out, flags);
+    if (flags & 1) WriteVal<double>(out, upref->second);
+    if (flags & 2) WriteVal<double>(out, vpref->second);
+
+    std::map<Arc, std::vector<double>>::const_iterator ucaps =
+        u->unit_capacities.find(a);
+    std::map<Arc, std::vector<double>>::const_iterator vcaps =
+        v->unit_capacities.find(a);
+    WriteDoubles(out, ucaps != u->unit_capacities.end() ? ucaps->second
+                                                        : std::vector<double>());
+    WriteDoubles(out, vcaps != v->unit_capacities.end() ? vcaps->second
+                                                        : std::vector<double>());
+  }
+
+  if (!out) {
+    throw IOError("could not write exchange graph");
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ExchangeGraph::Ptr ReadGraph(std::istream& in) {
+  char magic[sizeof(kGraphMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in || !std::equal(magic, magic + sizeof(magic), kGraphMagic)) {
+    throw IOError("stream does not hold an exchange graph");
+  }
+  uint32_t version = ReadVal<uint32_t>(in);
+  if (version != kGraphVersion) {
+    std::stringstream ss;
+    ss << "unsupported exchange graph format version " << version;
+    throw IOError(ss.str());
+  }
+
+  std::vector<std::string> commods(ReadVal<uint32_t>(in));
+  for (int i = 0; i < commods.size(); ++i) {
+    commods[i].resize(ReadVal<uint32_t>(in));
+    if (!commods[i].empty()) {
+      in.read(&commods[i][0], commods[i].size());
+    }
+  }
+
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  std::vector<ExchangeNode::Ptr> nodes;
+  uint32_t n_groups = ReadVal<uint32_t>(in);
+  for (uint32_t i = 0; i < n_groups; ++i) {
+    RequestGroup::Ptr rg(new RequestGroup(ReadVal<double>(in)));
+    ReadGroup(in, rg.get(), commods, &nodes);
+    g->AddRequestGroup(rg);
+  }
+  n_groups = ReadVal<uint32_t>(in);
+  for (uint32_t i = 0; i < n_groups; ++i) {
+    ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+    ReadGroup(in, sg.get(), commods, &nodes);
+    g->AddSupplyGroup(sg);
+  }
+
+  uint32_t n_arcs = ReadVal<uint32_t>(in);
+  for (uint32_t i = 0; i < n_arcs; ++i) {
+    uint32_t uid = ReadVal<uint32_t>(in);
+    uint32_t vid = ReadVal<uint32_t>(in);
+    if (uid >= nodes.size() || vid >= nodes.size()) {
+      throw IOError("exchange graph file has an invalid node index");
+    }
+    ExchangeNode::Ptr u = nodes[uid];
+    ExchangeNode::Ptr v = nodes[vid];
+    Arc a(u, v);
+    a.pref(ReadVal<double>(in));
+
+    uint8_t flags = ReadVal<uint8_t>(in);
+    if (flags & 1) u->prefs[a] = ReadVal<double>(in);
+    if (flags & 2) v->prefs[a] = ReadVal<double>(in);
+
+    std::vector<double> ucaps = ReadDoubles(in);
+    std::vector<double> vcaps = ReadDoubles(in);
+    if (!ucaps.empty()) u->unit_capacities[a] = ucaps;
+    if (!vcaps.empty()) v->unit_capacities[a] = vcaps;
+    g->AddArc(a);
+  }
+  return g;
+}
+
 }  // namespace cyclus
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_EXCHANGE_GRAPH_H_
 #define CYCLUS_SRC_EXCHANGE_GRAPH_H_
 
+#include <iosfwd>
 #include <limits>
 #include <map>
 #include <string>
@@ -271,6 +272,23 @@ class ExchangeGraph {
   int next_arc_id_;
 };
 
+/// @brief writes a compact binary representation of a graph, including its
+/// groups, nodes, capacities, unit capacities, preferences and exclusivity.
+/// Matches are not written. Graphs written by this function can be read back
+/// with ReadGraph() and solved independently of the simulation they came
+/// from.
+/// @param g the graph to write
+/// @param out a stream opened in binary mode
+/// @throws IOError if the stream can not be written to
+void WriteGraph(const ExchangeGraph& g, std::ostream& out);
+
+/// @brief reads a graph written by WriteGraph()
+/// @param in a stream opened in binary mode
+/// @return a new graph, equivalent to the one that was written
+/// @throws IOError if the stream does not hold a complete graph or was
+/// written with an unsupported format version
+ExchangeGraph::Ptr ReadGraph(std::istream& in);
+
 }  // namespace cyclus
 
 #endif  // CYCLUS_SRC_EXCHANGE_GRAPH_H_
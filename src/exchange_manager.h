@@ -2,7 +2,10 @@
 #define CYCLUS_SRC_EXCHANGE_MANAGER_H_
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
+#include "exchange_arena.h"
 #include "exchange_graph.h"
 #include "exchange_solver.h"
 #include "exchange_translator.h"
@@ -24,14 +27,33 @@ namespace cyclus {
 /// ExchangeManager<ResourceType> manager(ctx);
 /// manager.Execute();
 /// @endcode
+///
+/// If the CYCLUS_DRE_CAPTURE environment variable names a directory, each
+/// translated ExchangeGraph is written there with WriteGraph() before it is
+/// solved, one file per resource type and timestep (e.g.,
+/// Material_12.cyxg). Captured graphs can be replayed with cyclus_dre_bench.
+///
+/// If the CYCLUS_PARALLEL_TRADES environment variable is set, matched trades
+/// are executed with a parallel TradeExecutor, in which traders that opt in
+/// with Trader::ParallelTrades respond to and accept trades concurrently.
+///
+/// If the timer has an AgentProfiler, the time each trader spends making
+/// requests, bids and trades and accepting trades is added to it.
 template <class T> class ExchangeManager {
  public:
-  ExchangeManager(Context* ctx) : ctx_(ctx), debug_(false) {
+  ExchangeManager(Context* ctx)
+      : ctx_(ctx), debug_(false), parallel_trades_(false) {
     debug_ = Env::GetEnv("CYCLUS_DEBUG_DRE").size() > 0;
+    parallel_trades_ = Env::GetEnv("CYCLUS_PARALLEL_TRADES").size() > 0;
+    capture_dir_ = Env::GetEnv("CYCLUS_DRE_CAPTURE");
   }
 
   /// @brief execute the full resource sequence
   void Execute() {
+    // all requests and bids made during this exchange live in the arena and
+    // are released together when the scope ends
+    typename ExchangeArena<T>::Scope scope(&arena_);
+
     // collect resource exchange information
     ResourceExchange<T> exchng(ctx_);
     exchng.AddAllRequests();
@@ -49,6 +71,8 @@ template <class T> class ExchangeManager {
     ExchangeGraph::Ptr graph = xlator.Translate();
     CLOG(LEV_DEBUG1) << "graph translated!";
 
+    if (!capture_dir_.empty()) CaptureGraph(*graph);
+
     // solve graph
     CLOG(LEV_DEBUG1) << "solving graph...";
     ctx_->solver()->Solve(graph.get());
@@ -60,16 +84,26 @@ template <class T> class ExchangeManager {
     CLOG(LEV_DEBUG1) << "trades translated!";
 
     // execute trades!
-    TradeExecutor<T> exec(trades);
+    TradeExecutor<T> exec(trades, parallel_trades_);
     exec.ExecuteTrades(ctx_, &exchng.ex_ctx());
   }
 
  private:
+  void CaptureGraph(const ExchangeGraph& graph) {
+    std::stringstream ss;
+    ss << capture_dir_ << "/" << T::kType << "_" << ctx_->time() << ".cyxg";
+    std::ofstream out(ss.str().c_str(), std::ios::binary);
+    if (!out) {
+      throw IOError("could not open exchange graph capture file " + ss.str());
+    }
+    WriteGraph(graph, out);
+  }
+
   void RecordDebugInfo(ExchangeContext<T>& exctx) {
     typename std::vector<typename RequestPortfolio<T>::Ptr>::iterator it;
     for (it = exctx.requests.begin(); it != exctx.requests.end(); ++it) {
-      std::vector<Request<T>*> reqs = (*it)->requests();
-      typename std::vector<Request<T>*>::iterator it2;
+      const std::vector<Request<T>*>& reqs = (*it)->requests();
+      typename std::vector<Request<T>*>::const_iterator it2;
       for (it2 = reqs.begin(); it2 != reqs.end(); ++it2) {
         Request<T>* r = *it2;
         std::stringstream ss;
@@ -90,18 +124,18 @@ template <class T> class ExchangeManager {
 
     typename std::vector<typename BidPortfolio<T>::Ptr>::iterator it3;
     for (it3 = exctx.bids.begin(); it3 != exctx.bids.end(); ++it3) {
-      std::set<Bid<T>*> bids = (*it3)->bids();
-      typename std::set<Bid<T>*>::iterator it4;
+      const std::vector<Bid<T>*>& bids = (*it3)->bids();
+      typename std::vector<Bid<T>*>::const_iterator it4;
       for (it4 = bids.begin(); it4 != bids.end(); ++it4) {
         Bid<T>* b = *it4;
         Request<T>* r = b->request();
-        double pref = exctx.trader_prefs[r->requester()][r][b];
+        double pref = exctx.prefs[b->id()];
         std::stringstream ss;
         ss << ctx_->time() << "_" << b->request();
         ctx_->NewDatum("DebugBids")
             ->AddVal("ReqId", ss.str())
             ->AddVal("BidderId", b->bidder()->manager()->id())
-            ->AddVal("BidQuantity", b->offer()->quantity())
+            ->AddVal("BidQuantity", b->offer_spec().qty())
             ->AddVal("Exclusive", b->exclusive())
             ->AddVal("Preference", pref)
             ->Record();
@@ -110,7 +144,10 @@ template <class T> class ExchangeManager {
   }
 
   bool debug_;
+  bool parallel_trades_;
+  std::string capture_dir_;
   Context* ctx_;
+  ExchangeArena<T> arena_;
 };
 
 }  // namespace cyclus
@@ -15,7 +15,7 @@
 
 namespace cyclus {
 
-template <class T> class ExchangeContext;
+template <class T> struct ExchangeContext;
 class Trader;
 
 /// @class ExchangeTranslator
@@ -61,8 +61,8 @@ template <class T> class ExchangeTranslator {
       graph->AddSupplyGroup(ns);
 
       // add each request-bid arc
-      const std::set<Bid<T>*>& bids = (*bp_it)->bids();
-      typename std::set<Bid<T>*>::const_iterator b_it;
+      const std::vector<Bid<T>*>& bids = (*bp_it)->bids();
+      typename std::vector<Bid<T>*>::const_iterator b_it;
       for (b_it = bids.begin(); b_it != bids.end(); ++b_it) {
         Bid<T>* bid = *b_it;
         Request<T>* req = bid->request();
@@ -76,7 +76,7 @@ template <class T> class ExchangeTranslator {
   /// @brief adds a bid-request arc to a graph, if the preference for the arc is
   /// non-negative
   void AddArc(Request<T>* req, Bid<T>* bid, ExchangeGraph::Ptr graph) {
-    double pref = ex_ctx_->trader_prefs.at(req->requester())[req][bid];
+    double pref = ex_ctx_->prefs.at(bid->id());
     // TODO: make the following check `pref <=0` and remove the `else if` block
     // before release 1.5
     if (pref < 0) {
@@ -181,26 +181,37 @@ ExchangeNodeGroup::Ptr TranslateBidPortfolio(
     const typename BidPortfolio<T>::Ptr bp) {
   ExchangeNodeGroup::Ptr bs(new ExchangeNodeGroup());
 
-  std::map<typename T::Ptr, std::vector<ExchangeNode::Ptr>> excl_bid_grps;
+  // exclusive groups are kept in the order their offers are first seen so
+  // that the graph does not depend on resource addresses. Bids sharing an
+  // offered resource are grouped; deferred offers belong to their bid alone.
+  std::vector<std::vector<ExchangeNode::Ptr>> excl_bid_grps;
+  std::map<const void*, int> excl_grp_idx;
 
-  typename std::set<Bid<T>*>::const_iterator b_it;
+  typename std::vector<Bid<T>*>::const_iterator b_it;
   for (b_it = bp->bids().begin(); b_it != bp->bids().end(); ++b_it) {
     Bid<T>* b = *b_it;
-    ExchangeNode::Ptr n(new ExchangeNode(b->offer()->quantity(),
+    ExchangeNode::Ptr n(new ExchangeNode(b->offer_spec().qty(),
                                          b->exclusive(),
                                          b->request()->commodity(),
                                          b->bidder()->manager()->id()));
     bs->AddExchangeNode(n);
     AddBid(translation_ctx, *b_it, n);
     if (b->exclusive()) {
-      excl_bid_grps[b->offer()].push_back(n);
+      const OfferSpec<T>& spec = b->offer_spec();
+      const void* key = spec.deferred()
+                            ? static_cast<const void*>(b)
+                            : static_cast<const void*>(spec.like().get());
+      std::pair<std::map<const void*, int>::iterator, bool> ins =
+          excl_grp_idx.insert(std::make_pair(key, excl_bid_grps.size()));
+      if (ins.second) {
+        excl_bid_grps.push_back(std::vector<ExchangeNode::Ptr>());
+      }
+      excl_bid_grps[ins.first->second].push_back(n);
     }
   }
 
-  typename std::map<typename T::Ptr, std::vector<ExchangeNode::Ptr>>::iterator
-      m_it;
-  for (m_it = excl_bid_grps.begin(); m_it != excl_bid_grps.end(); ++m_it) {
-    bs->AddExclGroup(m_it->second);
+  for (int i = 0; i < excl_bid_grps.size(); ++i) {
+    bs->AddExclGroup(excl_bid_grps[i]);
   }
 
   CLOG(LEV_DEBUG4) << "adding " << bp->constraints().size()
@@ -232,7 +243,7 @@ Arc TranslateArc(const ExchangeTranslationContext<T>& translation_ctx,
   Arc arc(unode, vnode);
   arc.pref(pref);
 
-  typename T::Ptr offer = bid->offer();
+  const OfferSpec<T>& offer = bid->offer_spec();
   typename BidPortfolio<T>::Ptr bp = bid->portfolio();
   typename RequestPortfolio<T>::Ptr rp = req->portfolio();
 
@@ -258,24 +269,33 @@ Trade<T> BackTranslateMatch(
   return t;
 }
 
-/// @brief updates a node's unit capacities given, a target resource and
+/// @brief updates a node's unit capacities given, a described offer and
 /// constraints
 template <typename T>
-void TranslateCapacities(typename T::Ptr offer,
+void TranslateCapacities(const OfferSpec<T>& offer,
                          const typename std::set<CapacityConstraint<T>>& constr,
                          ExchangeNode::Ptr n,
                          const Arc& a,
                          const ExchangeTranslationContext<T>& ctx) {
   typename std::set<CapacityConstraint<T>>::const_iterator it;
   for (it = constr.begin(); it != constr.end(); ++it) {
-    CLOG(cyclus::LEV_DEBUG1)
-        << "Additing unit capacity: "
-        << it->convert(offer, &a, &ctx) / offer->quantity();
-    n->unit_capacities[a].push_back(it->convert(offer, &a, &ctx) /
-                                    offer->quantity());
+    double ucap = it->convert(offer, &a, &ctx) / offer.qty();
+    CLOG(cyclus::LEV_DEBUG1) << "Additing unit capacity: " << ucap;
+    n->unit_capacities[a].push_back(ucap);
   }
 }
 
+/// @brief updates a node's unit capacities given, a target resource and
+/// constraints
+template <typename T>
+void TranslateCapacities(typename T::Ptr offer,
+                         const typename std::set<CapacityConstraint<T>>& constr,
+                         ExchangeNode::Ptr n,
+                         const Arc& a,
+                         const ExchangeTranslationContext<T>& ctx) {
+  TranslateCapacities<T>(OfferSpec<T>(offer), constr, n, a, ctx);
+}
+
 }  // namespace cyclus
 
 #endif  // CYCLUS_SRC_EXCHANGE_TRANSLATOR_H_
@@ -127,10 +127,34 @@ class Facility : public TimeListener, public Agent, public Trader {
     return std::set<BidPortfolio<Product>::Ptr>();
   }
 
+  /// @brief default implementation for material preferences, which forwards
+  /// the preferences to the nested-map AdjustMatlPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustMatlPrefs(PrefMap<Material>& prefs) {
+    AdjustMatlPrefs(prefs.legacy());
+  }
+
+  /// @brief default implementation for product preferences, which forwards
+  /// the preferences to the nested-map AdjustProductPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustProductPrefs(PrefMap<Product>& prefs) {
+    AdjustProductPrefs(prefs.legacy());
+  }
+
   /// default implementation for material preferences.
+  /// @deprecated override AdjustMatlPrefs(PrefMap<Material>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Facility::AdjustMatlPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {}
 
-  /// default implementation for material preferences.
+  /// default implementation for product preferences.
+  /// @deprecated override AdjustProductPrefs(PrefMap<Product>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Facility::AdjustProductPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustProductPrefs(PrefMap<Product>::type& prefs) {}
 
   /// @brief default implementation for responding to material trades
@@ -529,8 +529,9 @@ def get_setup(t, depth=0, prefix="", HDF5_type="tb_type", child_index='j'):
                                         type=Type(cpp="hid_t"),
                                         target=Var(name=field_type_var),
                                         value=FuncCall(
-                                            name=Raw(code="H5Tget_member_type"),
-                                            args=[Raw(code=HDF5_type),
+                                            name=Raw(code="H5Call"),
+                                            args=[Raw(code="H5Tget_member_type"),
+                                                  Raw(code=HDF5_type),
                                                   Raw(code=str(child_index))])))
         HDF5_type = field_type_var
 
@@ -538,8 +539,9 @@ def get_setup(t, depth=0, prefix="", HDF5_type="tb_type", child_index='j'):
     total_size = ExprStmt(child=DeclAssign(type=Type(cpp="unsigned int"),
                                            target=Var(name=total_size_var),
                                            value=FuncCall(
-                                              name=Raw(code="H5Tget_size"),
-                                              args=[Raw(code=HDF5_type)])))
+                                              name=Raw(code="H5Call"),
+                                              args=[Raw(code="H5Tget_size"),
+                                                    Raw(code=HDF5_type)])))
     if is_primitive(t):
         if t.canon == "STRING":
             setup_nodes.append(string_setup(depth=depth, prefix=prefix))
@@ -575,8 +577,9 @@ def get_setup(t, depth=0, prefix="", HDF5_type="tb_type", child_index='j'):
                                                   type=Type(cpp="hsize_t"),
                                                   name=Var(name=fieldlen_var))),
                                     ExprStmt(child=FuncCall(
-                                           name=Raw(code="H5Tget_array_dims2"),
-                                           args=[Raw(code=HDF5_type),
+                                           name=Raw(code="H5Call"),
+                                           args=[Raw(code="H5Tget_array_dims2"),
+                                                 Raw(code=HDF5_type),
                                                  Raw(code="&"+fieldlen_var)]))])
             setup_nodes.append(fieldlen)
             item_type_var = get_variable("item_type", depth=depth,
@@ -585,8 +588,9 @@ def get_setup(t, depth=0, prefix="", HDF5_type="tb_type", child_index='j'):
                                         type=Type(cpp="hid_t"),
                                         target=Var(name=item_type_var),
                                         value=FuncCall(
-                                            name=Raw(code="H5Tget_super"),
-                                            args=[Raw(code=HDF5_type)])))
+                                            name=Raw(code="H5Call"),
+                                            args=[Raw(code="H5Tget_super"),
+                                                  Raw(code=HDF5_type)])))
             setup_nodes.append(item_type)
             TEARDOWN_STACK.append(item_type_var)
             HDF5_type = item_type_var
@@ -1079,8 +1083,9 @@ def normal_close(t):
 
     for i in range(len(TEARDOWN_STACK)):
         var_name = TEARDOWN_STACK.pop()
-        teardown = ExprStmt(child=FuncCall(name=Var(name="H5Tclose"),
-                                           args=[Raw(code=var_name)]))
+        teardown = ExprStmt(child=FuncCall(name=Var(name="H5Call"),
+                                           args=[Raw(code="H5Tclose"),
+                                                 Raw(code=var_name)]))
         tree.nodes.append(teardown)
     return tree
 
@@ -1729,6 +1734,30 @@ def main_vl_dataset():
     output = indent(output, INDENT*2)
     return output
 
+def main_vl_read_batch():
+    """HDF5 VL_READ_BATCH: Generate the VLReadBatch dispatch code."""
+    CPPGEN = CppGen()
+    output = ""
+    origin_types = list(VARIATION_DICT.keys())
+    for origin in origin_types:
+        vals = [v.canon for v in VARIATION_DICT[origin] if DB_TO_VL[v.db]]
+        origin_node = CANON_TO_NODE[origin]
+        if vals == []:
+            if DB_TO_VL[origin_node.db]:
+                vals.append(origin)
+            else:
+                continue
+        for v in vals:
+            node = CANON_TO_NODE[v]
+            read_batch = FuncCall(name=Var(name="VLReadBatch"),
+                                  targs=[Raw(code=node.cpp), Raw(code=node.db)],
+                                  args=[Raw(code="keys")])
+            case_body = ExprStmt(child=read_batch)
+            output += CPPGEN.visit(case_template(node, case_body))
+
+    output = indent(output, INDENT*2)
+    return output
+
 def main_fill_buf():
     """HDF5 FILL_BUF: Generates the FillBuf function code."""
     CPPGEN = CppGen()
@@ -2836,6 +2865,7 @@ def setup():
     MAIN_DISPATCH = {"QUERY": main_query,
                      "CREATE": main_create,
                      "VL_DATASET": main_vl_dataset,
+                     "VL_READ_BATCH": main_vl_read_batch,
                      "FILL_BUF": main_fill_buf,
                      "WRITE": main_write,
                      "VAL_TO_BUF_H": main_val_to_buf_h,
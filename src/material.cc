@@ -30,6 +30,10 @@ Material::Ptr Material::CreateUntracked(double quantity, Composition::Ptr c,
   return m;
 }
 
+Material::Ptr Material::CreateUntracked(double quantity, Material::Ptr like) {
+  return CreateUntracked(quantity, like->comp());
+}
+
 int Material::qual_id() const {
   return comp_->id();
 }
@@ -90,6 +90,11 @@ class Material : public Resource {
   static Ptr CreateUntracked(double quantity, Composition::Ptr c,
                              double unit_value = kUnsetUnitValue);
 
+  /// Creates a new untracked material of the given quantity with the same
+  /// composition as like. This is used to realize offers described by an
+  /// OfferSpec.
+  static Ptr CreateUntracked(double quantity, Ptr like);
+
   /// Returns the id of the material's internal nuclide composition.
   virtual int qual_id() const;
 
@@ -0,0 +1,444 @@
+#include "mem_back.h"
+
+#include <typeinfo>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_hash.hpp>
+
+#include "blob.h"
+#include "datum.h"
+#include "error.h"
+
+namespace cyclus {
+
+inline std::size_t hash_value(const Blob& b) {
+  return boost::hash<std::string>()(b.str());
+}
+
+class MemBack::Column {
+ public:
+  Column(DbTypes type, const std::type_info* ti, const std::vector<int>& shape)
+      : type(type),
+        ti(ti),
+        shape(shape) {}
+
+  virtual ~Column() {}
+
+  /// Appends a value, which must be of the column's type.
+  virtual void Append(const boost::spirit::hold_any& v) = 0;
+
+  /// Returns the value at a row.
+  virtual boost::spirit::hold_any Get(int row) = 0;
+
+  /// Returns whether the value at a row satisfies a condition.
+  virtual bool Match(int row, Cond* cond) = 0;
+
+  /// Returns the rows, in increasing order, whose value equals that of an
+  /// equality condition. The column's index is built on first use.
+  virtual const std::vector<int>& Lookup(Cond* cond) = 0;
+
+  DbTypes type;
+  const std::type_info* ti;
+  std::vector<int> shape;
+};
+
+template <typename T>
+class TypedColumn : public MemBack::Column {
+ public:
+  TypedColumn(DbTypes type, const std::vector<int>& shape)
+      : MemBack::Column(type, &typeid(T), shape),
+        indexed_(false) {}
+
+  virtual void Append(const boost::spirit::hold_any& v) {
+    const T& x = v.cast<T>();
+    if (indexed_)
+      index_[x].push_back(vals_.size());
+    vals_.push_back(x);
+  }
+
+  virtual boost::spirit::hold_any Get(int row) {
+    return vals_[row];
+  }
+
+  virtual bool Match(int row, Cond* cond) {
+    // binds to a copy for the packed std::vector<bool>
+    const T& x = vals_[row];
+    return CmpCond<T>(const_cast<T*>(&x), cond);
+  }
+
+  virtual const std::vector<int>& Lookup(Cond* cond) {
+    if (!indexed_) {
+      for (int i = 0; i < vals_.size(); ++i)
+        index_[vals_[i]].push_back(i);
+      indexed_ = true;
+    }
+    typename Index::iterator it = index_.find(cond->val.cast<T>());
+    return it == index_.end() ? empty_ : it->second;
+  }
+
+ private:
+  typedef std::unordered_map<T, std::vector<int>, boost::hash<T> > Index;
+
+  std::vector<T> vals_;
+  bool indexed_;
+  Index index_;
+  std::vector<int> empty_;
+};
+
+typedef MemBack::Column* (*ColumnFactory)(DbTypes, const std::vector<int>&);
+
+template <typename T>
+MemBack::Column* NewColumn(DbTypes type, const std::vector<int>& shape) {
+  return new TypedColumn<T>(type, shape);
+}
+
+typedef bool (*ValueComparer)(const boost::spirit::hold_any&,
+                              const boost::spirit::hold_any&);
+
+template <typename T>
+bool CompareValues(const boost::spirit::hold_any& a,
+                   const boost::spirit::hold_any& b) {
+  return a.cast<T>() == b.cast<T>();
+}
+
+/// The database type of a C++ type and how to store and compare its values.
+struct ColumnType {
+  DbTypes type;
+  ColumnFactory make;
+  ValueComparer equal;
+};
+
+static std::map<const std::type_info*, ColumnType> column_types;
+
+template <typename T>
+static void AddColumnType(DbTypes type) {
+  ColumnType ct = {type, &NewColumn<T>, &CompareValues<T>};
+  column_types[&typeid(T)] = ct;
+}
+
+/// Returns the column type for values like v, or NULL if they cannot be
+/// stored. Every fixed length type that Hdf5Back supports can be stored, so
+/// that MemBack can stage any data that is also recorded to a disk backend.
+static ColumnType* FindColumnType(const boost::spirit::hold_any& v) {
+  if (column_types.size() == 0) {
+    using boost::uuids::uuid;
+    using std::list;
+    using std::map;
+    using std::pair;
+    using std::set;
+    using std::string;
+    using std::vector;
+    AddColumnType<bool>(BOOL);
+    AddColumnType<int>(INT);
+    AddColumnType<float>(FLOAT);
+    AddColumnType<double>(DOUBLE);
+    AddColumnType<string>(STRING);
+    AddColumnType<Blob>(BLOB);
+    AddColumnType<uuid>(UUID);
+    AddColumnType<vector<int> >(VECTOR_INT);
+    AddColumnType<vector<float> >(VECTOR_FLOAT);
+    AddColumnType<vector<double> >(VECTOR_DOUBLE);
+    AddColumnType<vector<string> >(VECTOR_STRING);
+    AddColumnType<vector<Blob> >(VECTOR_BLOB);
+    AddColumnType<vector<uuid> >(VECTOR_UUID);
+    AddColumnType<set<int> >(SET_INT);
+    AddColumnType<set<float> >(SET_FLOAT);
+    AddColumnType<set<double> >(SET_DOUBLE);
+    AddColumnType<set<string> >(SET_STRING);
+    AddColumnType<set<Blob> >(SET_BLOB);
+    AddColumnType<set<uuid> >(SET_UUID);
+    AddColumnType<list<bool> >(LIST_BOOL);
+    AddColumnType<list<int> >(LIST_INT);
+    AddColumnType<list<float> >(LIST_FLOAT);
+    AddColumnType<list<double> >(LIST_DOUBLE);
+    AddColumnType<list<string> >(LIST_STRING);
+    AddColumnType<list<Blob> >(LIST_BLOB);
+    AddColumnType<list<uuid> >(LIST_UUID);
+    AddColumnType<pair<int, bool> >(PAIR_INT_BOOL);
+    AddColumnType<pair<int, int> >(PAIR_INT_INT);
+    AddColumnType<pair<int, float> >(PAIR_INT_FLOAT);
+    AddColumnType<pair<int, double> >(PAIR_INT_DOUBLE);
+    AddColumnType<pair<int, string> >(PAIR_INT_STRING);
+    AddColumnType<pair<int, Blob> >(PAIR_INT_BLOB);
+    AddColumnType<pair<int, uuid> >(PAIR_INT_UUID);
+    AddColumnType<pair<string, bool> >(PAIR_STRING_BOOL);
+    AddColumnType<pair<string, int> >(PAIR_STRING_INT);
+    AddColumnType<pair<string, float> >(PAIR_STRING_FLOAT);
+    AddColumnType<pair<string, double> >(PAIR_STRING_DOUBLE);
+    AddColumnType<pair<string, string> >(PAIR_STRING_STRING);
+    AddColumnType<pair<string, Blob> >(PAIR_STRING_BLOB);
+    AddColumnType<pair<string, uuid> >(PAIR_STRING_UUID);
+    AddColumnType<map<int, bool> >(MAP_INT_BOOL);
+    AddColumnType<map<int, int> >(MAP_INT_INT);
+    AddColumnType<map<int, float> >(MAP_INT_FLOAT);
+    AddColumnType<map<int, double> >(MAP_INT_DOUBLE);
+    AddColumnType<map<int, string> >(MAP_INT_STRING);
+    AddColumnType<map<int, Blob> >(MAP_INT_BLOB);
+    AddColumnType<map<int, uuid> >(MAP_INT_UUID);
+    AddColumnType<map<string, bool> >(MAP_STRING_BOOL);
+    AddColumnType<map<string, int> >(MAP_STRING_INT);
+    AddColumnType<map<string, float> >(MAP_STRING_FLOAT);
+    AddColumnType<map<string, double> >(MAP_STRING_DOUBLE);
+    AddColumnType<map<string, string> >(MAP_STRING_STRING);
+    AddColumnType<map<string, Blob> >(MAP_STRING_BLOB);
+    AddColumnType<map<string, uuid> >(MAP_STRING_UUID);
+    AddColumnType<map<pair<int, string>, double> >(MAP_PAIR_INT_STRING_DOUBLE);
+    AddColumnType<map<string, vector<double> > >(MAP_STRING_VECTOR_DOUBLE);
+    AddColumnType<map<string, map<int, double> > >(MAP_STRING_MAP_INT_DOUBLE);
+    AddColumnType<map<string, pair<double, map<int, double> > > >(
+        MAP_STRING_PAIR_DOUBLE_MAP_INT_DOUBLE);
+    AddColumnType<map<string, pair<double, map<string, double> > > >(
+        MAP_STRING_PAIR_DOUBLE_MAP_STRING_DOUBLE);
+    AddColumnType<map<int, map<string, double> > >(MAP_INT_MAP_STRING_DOUBLE);
+    AddColumnType<map<string, vector<pair<int, pair<string, string> > > > >(
+        MAP_STRING_VECTOR_PAIR_INT_PAIR_STRING_STRING);
+    AddColumnType<list<pair<int, int> > >(LIST_PAIR_INT_INT);
+    AddColumnType<map<string, pair<string, vector<double> > > >(
+        MAP_STRING_PAIR_STRING_VECTOR_DOUBLE);
+    AddColumnType<map<string, map<string, int> > >(MAP_STRING_MAP_STRING_INT);
+    AddColumnType<vector<pair<pair<double, double>, map<string, double> > > >(
+        VECTOR_PAIR_PAIR_DOUBLE_DOUBLE_MAP_STRING_DOUBLE);
+    AddColumnType<pair<int, pair<string, string> > >(
+        PAIR_INT_PAIR_STRING_STRING);
+    AddColumnType<pair<double, double> >(PAIR_DOUBLE_DOUBLE);
+    AddColumnType<pair<pair<double, double>, map<string, double> > >(
+        PAIR_PAIR_DOUBLE_DOUBLE_MAP_STRING_DOUBLE);
+    AddColumnType<pair<double, map<int, double> > >(PAIR_DOUBLE_MAP_INT_DOUBLE);
+    AddColumnType<pair<double, map<string, double> > >(
+        PAIR_DOUBLE_MAP_STRING_DOUBLE);
+    AddColumnType<vector<pair<int, pair<string, string> > > >(
+        VECTOR_PAIR_INT_PAIR_STRING_STRING);
+    AddColumnType<pair<string, vector<double> > >(PAIR_STRING_VECTOR_DOUBLE);
+    AddColumnType<map<pair<string, string>, int> >(MAP_PAIR_STRING_STRING_INT);
+    AddColumnType<map<string, map<string, double> > >(
+        MAP_STRING_MAP_STRING_DOUBLE);
+  }
+
+  std::map<const std::type_info*, ColumnType>::iterator it =
+      column_types.find(&v.type());
+  return it == column_types.end() ? NULL : &it->second;
+}
+
+/// Creates an empty column for values like v.
+static MemBack::Column* CreateColumn(const boost::spirit::hold_any& v,
+                                     const std::vector<int>& shape) {
+  ColumnType* ct = FindColumnType(v);
+  if (ct == NULL)
+    throw ValueError(std::string("unsupported backend type ") +
+                     v.type().name());
+  return ct->make(ct->type, shape);
+}
+
+bool ValuesEqual(const boost::spirit::hold_any& a,
+                 const boost::spirit::hold_any& b) {
+  if (a.type() != b.type())
+    return false;
+  ColumnType* ct = FindColumnType(a);
+  return ct != NULL && ct->equal(a, b);
+}
+
+void MemBack::Notify(DatumList data) {
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    std::string name = (*it)->title();
+    if (tables_.count(name) == 0)
+      CreateTable(*it);
+    Table& tb = tables_[name];
+
+    const Datum::Vals& vals = (*it)->vals();
+    if (vals.size() != tb.cols.size())
+      throw ValueError("datum for table '" + name + "' has the wrong number "
+                       "of values.");
+    for (int i = 0; i < vals.size(); ++i) {
+      if (vals[i].second.type() != *tb.cols[i]->ti)
+        throw ValueError("value of field '" + tb.fields[i] + "' in table '" +
+                         name + "' has the wrong type.");
+    }
+    for (int i = 0; i < vals.size(); ++i)
+      tb.cols[i]->Append(vals[i].second);
+    ++tb.nrows;
+  }
+}
+
+std::string MemBack::Name() {
+  return ":memory:";
+}
+
+QueryResult MemBack::Query(std::string table, std::vector<Cond>* conds) {
+  Table& tb = GetTable(table);
+  QueryResult qr;
+  qr.fields = tb.fields;
+  for (int j = 0; j < tb.cols.size(); ++j)
+    qr.types.push_back(tb.cols[j]->type);
+
+  // Conditions on fields that the table does not have are ignored. The rows
+  // that are checked are narrowed down to the fewest rows matched by an
+  // equality condition.
+  std::vector<int> condcols;
+  std::vector<Cond*> condlist;
+  const std::vector<int>* candidates = NULL;
+  if (conds != NULL) {
+    for (int i = 0; i < conds->size(); ++i) {
+      Cond* cond = &(*conds)[i];
+      for (int j = 0; j < tb.fields.size(); ++j) {
+        if (tb.fields[j] != cond->field)
+          continue;
+        condcols.push_back(j);
+        condlist.push_back(cond);
+        if (cond->opcode == EQ) {
+          const std::vector<int>& rows = tb.cols[j]->Lookup(cond);
+          if (candidates == NULL || rows.size() < candidates->size())
+            candidates = &rows;
+        }
+        break;
+      }
+    }
+  }
+
+  int n = candidates == NULL ? tb.nrows : candidates->size();
+  for (int k = 0; k < n; ++k) {
+    int i = candidates == NULL ? k : (*candidates)[k];
+    bool is_row_selected = true;
+    for (int c = 0; c < condlist.size() && is_row_selected; ++c)
+      is_row_selected = tb.cols[condcols[c]]->Match(i, condlist[c]);
+    if (!is_row_selected)
+      continue;
+
+    QueryRow row(tb.cols.size());
+    for (int j = 0; j < tb.cols.size(); ++j)
+      row[j] = tb.cols[j]->Get(i);
+    qr.rows.push_back(row);
+  }
+  return qr;
+}
+
+std::map<std::string, DbTypes> MemBack::ColumnTypes(std::string table) {
+  Table& tb = GetTable(table);
+  std::map<std::string, DbTypes> rtn;
+  for (int j = 0; j < tb.fields.size(); ++j)
+    rtn[tb.fields[j]] = tb.cols[j]->type;
+  return rtn;
+}
+
+std::list<ColumnInfo> MemBack::Schema(std::string table) {
+  Table& tb = GetTable(table);
+  std::list<ColumnInfo> schema;
+  for (int j = 0; j < tb.fields.size(); ++j) {
+    schema.push_back(ColumnInfo(table, tb.fields[j], j, tb.cols[j]->type,
+                                tb.cols[j]->shape));
+  }
+  return schema;
+}
+
+std::set<std::string> MemBack::Tables() {
+  std::set<std::string> rtn;
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it)
+    rtn.insert(it->first);
+  return rtn;
+}
+
+void MemBack::Insert(const std::string& table, const QueryResult& qr) {
+  if (qr.rows.size() == 0)
+    return;
+
+  if (tables_.count(table) == 0) {
+    Table tb;
+    tb.nrows = 0;
+    tb.fields = qr.fields;
+    for (int j = 0; j < qr.fields.size(); ++j) {
+      tb.cols.push_back(boost::shared_ptr<Column>(
+          CreateColumn(qr.rows[0][j], std::vector<int>())));
+    }
+    tables_[table] = tb;
+  }
+  Table& tb = tables_[table];
+
+  if (qr.fields != tb.fields)
+    throw ValueError("query result for table '" + table + "' has the wrong "
+                     "fields.");
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    const QueryRow& row = qr.rows[i];
+    for (int j = 0; j < row.size(); ++j) {
+      if (row[j].type() != *tb.cols[j]->ti)
+        throw ValueError("value of field '" + tb.fields[j] + "' in table '" +
+                         table + "' has the wrong type.");
+    }
+  }
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    for (int j = 0; j < tb.cols.size(); ++j)
+      tb.cols[j]->Append(qr.rows[i][j]);
+    ++tb.nrows;
+  }
+}
+
+MemBack::Table& MemBack::GetTable(const std::string& table) {
+  std::map<std::string, Table>::iterator it = tables_.find(table);
+  if (it == tables_.end())
+    throw ValueError("Invalid table name " + table);
+  return it->second;
+}
+
+void MemBack::CreateTable(Datum* d) {
+  const Datum::Vals& vals = d->vals();
+  const Datum::Shapes& shapes = d->shapes();
+  Table tb;
+  tb.nrows = 0;
+  for (int i = 0; i < vals.size(); ++i) {
+    std::vector<int> shape;
+    if (i < shapes.size())
+      shape = shapes[i];
+    tb.fields.push_back(vals[i].first);
+    tb.cols.push_back(
+        boost::shared_ptr<Column>(CreateColumn(vals[i].second, shape)));
+  }
+  tables_[d->title()] = tb;
+}
+
+void QueryCache::Restrict(std::string prefix, std::vector<Cond> conds) {
+  restrict_[prefix] = conds;
+}
+
+QueryResult QueryCache::Query(std::string table, std::vector<Cond>* conds) {
+  Load(table);
+  QueryResult& empty = loaded_[table];
+  if (empty.fields.size() > 0)
+    return empty;
+  return mem_.Query(table, conds);
+}
+
+std::set<std::string> QueryCache::Tables() {
+  if (tables_.size() == 0)
+    tables_ = b_->Tables();
+  return tables_;
+}
+
+void QueryCache::Load(const std::string& table) {
+  if (loaded_.count(table) > 0)
+    return;
+  if (Tables().count(table) == 0)
+    throw ValueError("Invalid table name " + table);
+
+  std::vector<Cond>* conds = NULL;
+  std::size_t longest = 0;
+  std::map<std::string, std::vector<Cond> >::iterator it;
+  for (it = restrict_.begin(); it != restrict_.end(); ++it) {
+    const std::string& prefix = it->first;
+    if (table.compare(0, prefix.size(), prefix) == 0 &&
+        (conds == NULL || prefix.size() > longest)) {
+      conds = &it->second;
+      longest = prefix.size();
+    }
+  }
+
+  QueryResult qr = b_->Query(table, conds);
+  mem_.Insert(table, qr);
+  if (qr.rows.size() == 0) {
+    loaded_[table] = qr;
+  } else {
+    loaded_[table] = QueryResult();
+  }
+}
+
+}  // namespace cyclus
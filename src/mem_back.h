@@ -0,0 +1,137 @@
+#ifndef CYCLUS_SRC_MEM_BACK_H_
+#define CYCLUS_SRC_MEM_BACK_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "query_backend.h"
+
+namespace cyclus {
+
+/// A Recorder backend that keeps all recorded data in memory, so that it can
+/// be queried without a round trip through a database file. It can serve as
+/// the only backend of short runs and tests, or be registered next to a disk
+/// backend so that queries made during a simulation are served from memory.
+///
+/// Each table is stored as one vector of values per column, typed by the C++
+/// type of the column, and query conditions are evaluated directly on these
+/// values. The first time a column is queried with an equality condition, a
+/// hash index from its values to rows is built and is then kept up to date as
+/// rows are added, so that lookups on key columns (e.g. AgentId, SimId) do not
+/// scan the whole table. The value types of Hdf5Back are supported.
+class MemBack : public FullBackend {
+ public:
+  /// A typed column of a table, defined in mem_back.cc.
+  class Column;
+
+  MemBack() {}
+
+  virtual ~MemBack() {}
+
+  /// Appends the Datum objects to their tables, creating tables as needed.
+  virtual void Notify(DatumList data);
+
+  /// Returns ":memory:".
+  virtual std::string Name();
+
+  /// Does nothing, data is never buffered.
+  virtual void Flush() {}
+
+  /// Does nothing, data stays available until the backend is destroyed.
+  virtual void Close() {}
+
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table);
+
+  virtual std::list<ColumnInfo> Schema(std::string table);
+
+  virtual std::set<std::string> Tables();
+
+  /// Appends the rows of a query result to a table, creating the table from
+  /// the result's fields and first row if it does not exist yet. Throws a
+  /// ValueError if the fields or value types do not match the table.
+  void Insert(const std::string& table, const QueryResult& qr);
+
+ private:
+  /// The columns of a table and its number of rows.
+  struct Table {
+    std::vector<std::string> fields;
+    std::vector<boost::shared_ptr<Column> > cols;
+    int nrows;
+  };
+
+  /// Returns a table, throwing a ValueError if it does not exist.
+  Table& GetTable(const std::string& table);
+
+  /// Creates the table for d with a column for each of its values.
+  void CreateTable(Datum* d);
+
+  /// Map of table name to table.
+  std::map<std::string, Table> tables_;
+};
+
+/// Returns whether a and b hold equal values of the same type. Values of types
+/// that MemBack cannot store are never equal.
+bool ValuesEqual(const boost::spirit::hold_any& a,
+                 const boost::spirit::hold_any& b);
+
+/// Wrapper class for QueryableBackends that answers queries from in-memory
+/// copies of the wrapped backend's tables. The first query of a table reads
+/// all of its rows from the wrapped backend at once, and that query and all
+/// later ones are answered by a MemBack, whose hash indexes turn the many
+/// lookups by key done when restoring a simulation into constant time
+/// operations instead of one backend query each.
+///
+/// The rows that are read can be restricted by table name prefix with
+/// Restrict, in which case queries must only ask for rows that satisfy the
+/// restricting conditions. Tables are never read again, so the wrapped
+/// backend must not change while it is wrapped.
+class QueryCache : public QueryableBackend {
+ public:
+  QueryCache(QueryableBackend* b) : b_(b) {}
+
+  virtual ~QueryCache() {}
+
+  /// Only reads the rows satisfying conds from tables whose names start with
+  /// prefix. The longest matching prefix is used.
+  void Restrict(std::string prefix, std::vector<Cond> conds);
+
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table) {
+    return b_->ColumnTypes(table);
+  }
+
+  virtual std::list<ColumnInfo> Schema(std::string table) {
+    return b_->Schema(table);
+  }
+
+  virtual std::set<std::string> Tables();
+
+ private:
+  /// Reads a table from the wrapped backend if it has not been read yet.
+  void Load(const std::string& table);
+
+  QueryableBackend* b_;
+  MemBack mem_;
+
+  /// map of table name prefix to the conditions restricting its rows
+  std::map<std::string, std::vector<Cond> > restrict_;
+
+  /// tables of the wrapped backend, read on first use
+  std::set<std::string> tables_;
+
+  /// tables that have been read, with the fields and types of those that had
+  /// no rows and so are not stored in mem_
+  std::map<std::string, QueryResult> loaded_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_MEM_BACK_H_
@@ -15,6 +15,7 @@ int Product::next_qualid_ = 1;
 Product::Ptr Product::Create(Agent* creator, double quantity,
                              std::string quality, std::string package_name,
                              double unit_value) {
+#pragma omp critical(cyclus_record)
   if (qualids_.count(quality) == 0) {
     qualids_[quality] = next_qualid_++;
     creator->context()
@@ -39,6 +40,10 @@ Product::Ptr Product::CreateUntracked(double quantity, std::string quality) {
   return r;
 }
 
+Product::Ptr Product::CreateUntracked(double quantity, Product::Ptr like) {
+  return CreateUntracked(quantity, like->quality());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Resource::Ptr Product::Clone() const {
   Product* g = new Product(*this);
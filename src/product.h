@@ -35,6 +35,11 @@ class Product : public Resource {
   /// the simulation and is untracked.
   static Ptr CreateUntracked(double quantity, std::string quality);
 
+  /// Creates a new untracked product of the given quantity with the same
+  /// quality as like. This is used to realize offers described by an
+  /// OfferSpec.
+  static Ptr CreateUntracked(double quantity, Ptr like);
+
   /// Returns 0 (for now).
   virtual int qual_id() const { return qualids_[quality_]; }
 
@@ -4,6 +4,10 @@
 #ifdef CYCLUS_WITH_PYTHON
 #include <stdlib.h>
 
+#include <map>
+#include <set>
+#include <vector>
+
 #include "eventhooks_api.h"
 #include "pyinfile_api.h"
 #include "pymodule_api.h"
@@ -77,6 +81,53 @@ void PyCallListeners(std::string tstype, Agent* agent, void* cpp_ctx, int time,
   py_call_listeners(tstype, agent, cpp_ctx, time, value);
 };
 
+/// The time series values recorded for the Python listeners of one series.
+struct PyListenerBuffer {
+  void* ctx;
+  std::vector<Agent*> agents;
+  std::vector<int> times;
+  std::vector<boost::spirit::hold_any> values;
+};
+
+static std::set<std::string> py_listened_series;
+static std::map<std::string, PyListenerBuffer> py_listener_buffers;
+
+void PyAddTimeSeriesListener(std::string tsname) {
+  py_listened_series.insert(tsname);
+};
+
+bool PyHasTimeSeriesListeners(const std::string& tsname) {
+  return !py_listened_series.empty() && py_listened_series.count(tsname) > 0;
+};
+
+void PyBufferListeners(std::string tsname, Agent* agent, void* cpp_ctx,
+                       int time, boost::spirit::hold_any value) {
+#pragma omp critical(py_listeners)
+  {
+    PyListenerBuffer& buf = py_listener_buffers[tsname];
+    buf.ctx = cpp_ctx;
+    buf.agents.push_back(agent);
+    buf.times.push_back(time);
+    buf.values.push_back(value);
+  }
+};
+
+void PyFlushListeners(void) {
+  if (py_listener_buffers.empty())
+    return;
+
+  // listeners may record more values, which are delivered by the next flush
+  std::map<std::string, PyListenerBuffer> bufs;
+  bufs.swap(py_listener_buffers);
+  import_pymodule();
+  std::map<std::string, PyListenerBuffer>::iterator it;
+  for (it = bufs.begin(); it != bufs.end(); ++it) {
+    PyListenerBuffer& buf = it->second;
+    py_call_listeners_batch(it->first, buf.agents, buf.ctx, buf.times,
+                            buf.values);
+  }
+};
+
 }  // namespace toolkit
 }  // namespace cyclus
 #else  // else CYCLUS_WITH_PYTHON
@@ -127,6 +178,17 @@ void PyCallListeners(std::string tsname,
                      int time,
                      boost::spirit::hold_any value) {};
 
+void PyAddTimeSeriesListener(std::string tsname) {};
+
+bool PyHasTimeSeriesListeners(const std::string& tsname) {
+  return false;
+};
+
+void PyBufferListeners(std::string tsname, Agent* agent, void* cpp_ctx,
+                       int time, boost::spirit::hold_any value) {};
+
+void PyFlushListeners(void) {};
+
 }  // namespace toolkit
 }  // namespace cyclus
 #endif  // ends CYCLUS_WITH_PYTHON
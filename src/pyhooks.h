@@ -56,6 +56,26 @@ std::string JsonToPy(std::string);
 void PyCallListeners(std::string tsname, Agent* agent, void* cpp_ctx, int time,
                      boost::spirit::hold_any value);
 
+/// Marks that Python listeners may be registered for a time series. This is
+/// called by the Python bindings whenever a series is added to
+/// cyclus.lib.TIME_SERIES_LISTENERS.
+void PyAddTimeSeriesListener(std::string tsname);
+
+/// Returns true if Python listeners may be registered for a time series. This
+/// is always false if Python was not installed with Cyclus.
+bool PyHasTimeSeriesListeners(const std::string& tsname);
+
+/// Buffers a time series value until the Python listeners are called with
+/// PyFlushListeners. This may be called concurrently.
+void PyBufferListeners(std::string tsname, Agent* agent, void* cpp_ctx,
+                       int time, boost::spirit::hold_any value);
+
+/// Calls the Python listeners of each time series once with all of the values
+/// buffered since the last flush, in the order they were recorded. This is
+/// called at the end of each time step and before any agent is deleted, since
+/// buffered values hold a pointer to the agent that recorded them.
+void PyFlushListeners(void);
+
 }  // namespace toolkit
 }  // namespace cyclus
 #endif  // ends CYCLUS_SRC_PYHOOKS_H_
@@ -1,5 +1,6 @@
 """Header for Cyclus Python Input Files."""
 from libcpp.string cimport string as std_string
+from libcpp.vector cimport vector
 from libcpp.typeinfo cimport type_info
 from cpython.pycapsule cimport PyCapsule_New, PyCapsule_GetPointer
 
@@ -62,3 +63,7 @@ cdef public api void py_del_agent "CyclusPyDelAgent" (int i) except *
 
 cdef public api void py_call_listeners "CyclusPyCallListeners" (std_string cpp_tsname,
                             Agent* cpp_agent, void* cpp_ctx, int time, hold_any cpp_value) except *
+
+cdef public api void py_call_listeners_batch "CyclusPyCallListenersBatch" (std_string cpp_tsname,
+                            vector[agent_ptr]& cpp_agents, void* cpp_ctx, vector[int]& times,
+                            vector[hold_any]& cpp_values) except *
@@ -2,6 +2,7 @@
 from __future__ import print_function, unicode_literals
 from libcpp.cast cimport reinterpret_cast, dynamic_cast
 from libcpp.string cimport string as std_string
+from libcpp.vector cimport vector
 from cpython.exc cimport PyErr_CheckSignals
 from cpython.pycapsule cimport PyCapsule_New, PyCapsule_GetPointer
 
@@ -96,3 +97,23 @@ cdef public api void py_call_listeners "CyclusPyCallListeners" (std_string cpp_t
     py_value = ts.capsule_any_to_py(value)
     cyclib.call_listeners(py_tsname, py_agent, time, py_value)
     PyErr_CheckSignals()
+
+
+cdef public api void py_call_listeners_batch "CyclusPyCallListenersBatch" (std_string cpp_tsname,
+                            vector[agent_ptr]& cpp_agents, void* cpp_ctx, vector[int]& times,
+                            vector[hold_any]& cpp_values) except *:
+    """Calls the python time series listeners with all values of a time series
+    recorded since the last call.
+    """
+    ctx = PyCapsule_New(cpp_ctx, <char*> b"ctx", NULL)
+    py_tsname = std_string_to_py(cpp_tsname)
+    py_agents = []
+    py_values = []
+    cdef int i
+    for i in range(cpp_agents.size()):
+        agent = PyCapsule_New(cpp_agents[i], <char*> b"agent", NULL)
+        value = PyCapsule_New(&cpp_values[i], <char*> b"value", NULL)
+        py_agents.append(cyclib.capsule_agent_to_py(agent, ctx))
+        py_values.append(ts.capsule_any_to_py(value))
+    cyclib.call_listeners_batch(py_tsname, py_agents, times, py_values)
+    PyErr_CheckSignals()
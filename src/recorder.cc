@@ -85,6 +85,14 @@ Datum* Recorder::NewDatum(std::string title) {
 }
 
 void Recorder::AddDatum(Datum* d) {
+  if (!stages_.empty()) {
+    DatumList one(1, d);
+    std::list<RecBackend*>::iterator it;
+    for (it = stages_.begin(); it != stages_.end(); it++) {
+      (*it)->Notify(one);
+    }
+  }
+
   if (index_ >= data_.size()) {
     NotifyBackends();
   }
@@ -114,9 +122,18 @@ void Recorder::RegisterBackend(RecBackend* b) {
   backs_.push_back(b);
 }
 
+void Recorder::RegisterStagingBackend(RecBackend* b) {
+  stages_.push_back(b);
+}
+
+void Recorder::UnregisterStagingBackend(RecBackend* b) {
+  stages_.remove(b);
+}
+
 void Recorder::Close() {
   Flush();
   backs_.clear();
+  stages_.clear();
 }
 
 }  // namespace cyclus
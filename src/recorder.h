@@ -107,11 +107,25 @@ class Recorder {
   /// @param b backend to receive Datum objects
   void RegisterBackend(RecBackend* b);
 
+  /// Registers b to receive each Datum as soon as it is recorded, in a
+  /// single-element DatumList, rather than when the buffer is flushed. This
+  /// lets data recorded during setup be read back right away (e.g. from a
+  /// MemBack) without flushing every registered backend. Staging backends
+  /// are never flushed or closed by the Recorder and must copy what they
+  /// need from each Datum during Notify.
+  ///
+  /// @param b backend to receive Datum objects as they are recorded
+  void RegisterStagingBackend(RecBackend* b);
+
+  /// Stops sending recorded Datum objects to the staging backend b. Does
+  /// nothing if b is not registered.
+  void UnregisterStagingBackend(RecBackend* b);
+
   /// Flushes all buffered Datum objects and flushes all registered backends.
   void Flush();
 
   /// Flushes all buffered Datum objects and flushes all registered backends.
-  /// Unregisters all backends and resets.
+  /// Unregisters all backends, including staging backends, and resets.
   void Close();
 
  private:
@@ -121,6 +135,7 @@ class Recorder {
   DatumList data_;
   int index_;
   std::list<RecBackend*> backs_;
+  std::list<RecBackend*> stages_;
   unsigned int dump_count_;
   boost::uuids::uuid uuid_;
   bool inject_sim_id_;
@@ -19,6 +19,8 @@ static const double kDefaultPref = 1;
 
 class Trader;
 template <class T> class RequestPortfolio;
+template <class T> struct ExchangeContext;
+template <class T> class ExchangeArena;
 
 /// @class Request
 ///
@@ -116,7 +118,14 @@ template <class T> class Request {
   /// @return the cost function for the request
   inline cost_function_t cost_function() const { return cost_function_; }
 
+  /// @return the dense index assigned to this request by the ExchangeContext
+  /// it was added to, or -1 if it has not been added to one
+  inline int id() const { return id_; }
+
  private:
+  friend struct ExchangeContext<T>;
+  friend class ExchangeArena<T>;
+
   /// @brief constructors are private to require use of factory methods
   Request(boost::shared_ptr<T> target, Trader* requester, std::string commodity,
           double preference, bool exclusive, cost_function_t cost_function)
@@ -125,7 +134,8 @@ template <class T> class Request {
         commodity_(commodity),
         preference_(preference),
         exclusive_(exclusive),
-        cost_function_(cost_function) {}
+        cost_function_(cost_function),
+        id_(-1) {}
 
   /// @brief constructors are private to require use of factory methods
   Request(boost::shared_ptr<T> target, Trader* requester,
@@ -136,7 +146,8 @@ template <class T> class Request {
         commodity_(commodity),
         preference_(preference),
         exclusive_(exclusive),
-        cost_function_(NULL) {}
+        cost_function_(NULL),
+        id_(-1) {}
 
   Request(boost::shared_ptr<T> target, Trader* requester,
           typename RequestPortfolio<T>::Ptr portfolio, std::string commodity,
@@ -147,7 +158,8 @@ template <class T> class Request {
         preference_(preference),
         portfolio_(portfolio),
         exclusive_(exclusive),
-        cost_function_(cost_function) {}
+        cost_function_(cost_function),
+        id_(-1) {}
 
   Request(boost::shared_ptr<T> target, Trader* requester,
           typename RequestPortfolio<T>::Ptr portfolio,
@@ -159,7 +171,8 @@ template <class T> class Request {
         preference_(preference),
         portfolio_(portfolio),
         exclusive_(exclusive),
-        cost_function_(NULL) {}
+        cost_function_(NULL),
+        id_(-1) {}
 
   boost::shared_ptr<T> target_;
   Trader* requester_;
@@ -168,6 +181,7 @@ template <class T> class Request {
   boost::weak_ptr<RequestPortfolio<T>> portfolio_;
   bool exclusive_;
   cost_function_t cost_function_;
+  int id_;
 };
 
 }  // namespace cyclus
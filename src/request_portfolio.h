@@ -12,6 +12,7 @@
 
 #include "capacity_constraint.h"
 #include "error.h"
+#include "exchange_arena.h"
 #include "logger.h"
 #include "request.h"
 
@@ -40,6 +41,13 @@ template <class T> struct QtyCoeffConverter : public Converter<T> {
     return offer->quantity() * coeffs.at(ctx->node_to_request.at(a->unode()));
   }
 
+  inline virtual double convert_offer(
+      const OfferSpec<T>& spec,
+      Arc const* a,
+      ExchangeTranslationContext<T> const* ctx) const {
+    return spec.qty() * coeffs.at(ctx->node_to_request.at(a->unode()));
+  }
+
   virtual bool operator==(Converter<T>& other) const {
     QtyCoeffConverter<T>* cast = dynamic_cast<QtyCoeffConverter<T>*>(&other);
     return cast != NULL && coeffs == cast->coeffs;
@@ -90,10 +98,17 @@ class RequestPortfolio
   typedef std::function<double(boost::shared_ptr<T>)> cost_function_t;
   typedef Request<T>* request_ptr;
 
-  RequestPortfolio() : requester_(NULL), qty_(0) {}
+  /// @brief default constructor. If an ExchangeArena is active, requests
+  /// added to this portfolio are allocated from (and owned by) that arena.
+  RequestPortfolio()
+      : requester_(NULL), qty_(0), arena_(ExchangeArena<T>::current()) {}
 
-  /// deletes all requests associated with it
+  /// deletes all requests associated with it, unless they are owned by an
+  /// arena
   ~RequestPortfolio() {
+    if (arena_ != NULL) {
+      return;
+    }
     typename std::vector<Request<T>*>::iterator it;
     for (it = requests_.begin(); it != requests_.end(); ++it) {
       delete *it;
@@ -116,9 +131,14 @@ class RequestPortfolio
   Request<T>* AddRequest(boost::shared_ptr<T> target, Trader* requester,
                          std::string commodity, double preference,
                          bool exclusive, cost_function_t cost_function) {
-    Request<T>* r =
-        Request<T>::Create(target, requester, this->shared_from_this(),
-                           commodity, preference, exclusive, cost_function);
+    Request<T>* r;
+    if (arena_ != NULL) {
+      r = arena_->NewRequest(target, requester, this->shared_from_this(),
+                             commodity, preference, exclusive, cost_function);
+    } else {
+      r = Request<T>::Create(target, requester, this->shared_from_this(),
+                             commodity, preference, exclusive, cost_function);
+    }
     VerifyRequester_(r);
     requests_.push_back(r);
     mass_coeffs_[r] = 1;
@@ -192,6 +212,16 @@ class RequestPortfolio
   }
 
  private:
+  friend class ExchangeArena<T>;
+
+  /// @brief keeps the storage of an ExchangeArena, and so this portfolio's
+  /// requests, alive for as long as this portfolio
+  void Keep(const boost::shared_ptr<void>& storage) {
+    if (kept_.empty() || kept_.back() != storage) {
+      kept_.push_back(storage);
+    }
+  }
+
   /// @brief copy constructor is private to prevent copying and preserve
   /// explicit single-ownership of requests
   RequestPortfolio(const RequestPortfolio& rhs) {
@@ -233,6 +263,13 @@ class RequestPortfolio
   /// the total quantity of resources associated with the portfolio
   double qty_;
   Trader* requester_;
+
+  /// the arena owning this portfolio's requests, if any
+  ExchangeArena<T>* arena_;
+
+  /// arena storage kept alive for requests made in exchanges that this portfolio
+  /// has outlived
+  std::vector<boost::shared_ptr<void>> kept_;
 };
 
 }  // namespace cyclus
@@ -21,6 +21,7 @@ void ResTracker::Create(Agent* creator) {
   parent2_ = 0;
   bool bumpId = false;
   Record(bumpId);
+#pragma omp critical(cyclus_record)
   ctx_->NewDatum("ResCreators")
       ->AddVal("ResourceId", res_->state_id())
       ->AddVal("AgentId", creator->id())
@@ -97,20 +98,25 @@ void ResTracker::Record(bool bumpId) {
   if (bumpId) {
     res_->BumpStateId();
   }
-  ctx_->NewDatum("Resources")
-      ->AddVal("ResourceId", res_->state_id())
-      ->AddVal("ObjId", res_->obj_id())
-      ->AddVal("Type", res_->type())
-      ->AddVal("TimeCreated", ctx_->time())
-      ->AddVal("Quantity", res_->quantity())
-      ->AddVal("Units", res_->units())
-      ->AddVal("UnitValue", res_->UnitValue())
-      ->AddVal("QualId", res_->qual_id())
-      ->AddVal("PackageName", res_->package_name())
-      ->AddVal("Parent1", parent1_)
-      ->AddVal("Parent2", parent2_)
-      ->Record();
-  res_->Record(ctx_);
+  // resources may be recorded from parallel trade execution, but the
+  // recorder hands out datums one at a time
+#pragma omp critical(cyclus_record)
+  {
+    ctx_->NewDatum("Resources")
+        ->AddVal("ResourceId", res_->state_id())
+        ->AddVal("ObjId", res_->obj_id())
+        ->AddVal("Type", res_->type())
+        ->AddVal("TimeCreated", ctx_->time())
+        ->AddVal("Quantity", res_->quantity())
+        ->AddVal("Units", res_->units())
+        ->AddVal("UnitValue", res_->UnitValue())
+        ->AddVal("QualId", res_->qual_id())
+        ->AddVal("PackageName", res_->package_name())
+        ->AddVal("Parent1", parent1_)
+        ->AddVal("Parent2", parent2_)
+        ->Record();
+    res_->Record(ctx_);
+  }
 }
 
 }  // namespace cyclus
@@ -6,8 +6,21 @@ int Resource::nextstate_id_ = 1;
 int Resource::nextobj_id_ = 1;
 
 void Resource::BumpStateId() {
-  state_id_ = nextstate_id_;
-  nextstate_id_++;
+  state_id_ = NextStateId();
+}
+
+int Resource::NextStateId() {
+  int id;
+#pragma omp atomic capture
+  id = nextstate_id_++;
+  return id;
+}
+
+int Resource::NextObjId() {
+  int id;
+#pragma omp atomic capture
+  id = nextobj_id_++;
+  return id;
 }
 
 }  // namespace cyclus
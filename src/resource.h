@@ -27,7 +27,7 @@ class Resource {
   typedef boost::shared_ptr<Resource> Ptr;
 
   Resource()
-      : state_id_(nextstate_id_++), unit_value_(0.0), obj_id_(nextobj_id_++) {}
+      : state_id_(NextStateId()), unit_value_(0.0), obj_id_(NextObjId()) {}
 
   virtual ~Resource() {}
 
@@ -120,6 +120,12 @@ class Resource {
       std::numeric_limits<double>::quiet_NaN();
 
  private:
+  /// Returns the next unused state (or object) id. Ids are handed out
+  /// atomically so that resources may be created and modified concurrently,
+  /// e.g. by suppliers responding to trades in parallel.
+  static int NextStateId();
+  static int NextObjId();
+
   double unit_value_;
   static int nextstate_id_;
   static int nextobj_id_;
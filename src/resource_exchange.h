@@ -5,6 +5,7 @@
 #include <functional>
 #include <set>
 
+#include "agent_profiler.h"
 #include "bid_portfolio.h"
 #include "context.h"
 #include "exchange_context.h"
@@ -19,17 +20,17 @@ namespace cyclus {
 /// @brief Preference adjustment method helpers to convert from templates to the
 /// Agent inheritance hierarchy
 template <class T>
-inline static void AdjustPrefs(Agent* m, typename PrefMap<T>::type& prefs) {}
-inline static void AdjustPrefs(Agent* m, PrefMap<Material>::type& prefs) {
+inline static void AdjustPrefs(Agent* m, PrefMap<T>& prefs) {}
+inline static void AdjustPrefs(Agent* m, PrefMap<Material>& prefs) {
   m->AdjustMatlPrefs(prefs);
 }
-inline static void AdjustPrefs(Agent* m, PrefMap<Product>::type& prefs) {
+inline static void AdjustPrefs(Agent* m, PrefMap<Product>& prefs) {
   m->AdjustProductPrefs(prefs);
 }
-inline static void AdjustPrefs(Trader* t, PrefMap<Material>::type& prefs) {
+inline static void AdjustPrefs(Trader* t, PrefMap<Material>& prefs) {
   t->AdjustMatlPrefs(prefs);
 }
-inline static void AdjustPrefs(Trader* t, PrefMap<Product>::type& prefs) {
+inline static void AdjustPrefs(Trader* t, PrefMap<Product>& prefs) {
   t->AdjustProductPrefs(prefs);
 }
 
@@ -62,7 +63,10 @@ template <class T> class ResourceExchange {
   /// @brief default constructor
   ///
   /// @param ctx the simulation context
-  ResourceExchange(Context* ctx) { sim_ctx_ = ctx; }
+  ResourceExchange(Context* ctx) {
+    sim_ctx_ = ctx;
+    prof_ = ctx->profiler();
+  }
 
   inline ExchangeContext<T>& ex_ctx() { return ex_ctx_; }
 
@@ -76,11 +80,15 @@ template <class T> class ResourceExchange {
                             std::placeholders::_1));
   }
 
-  /// @brief queries traders and collects all responses to requests for bids
+  /// @brief queries traders and collects all responses to requests for bids.
+  /// Traders that declared the commodities they supply (see
+  /// Context::SupplyCommods) are only queried if one of them is requested.
   void AddAllBids() {
     InitTraders();
-    std::for_each(traders_.begin(),
-                  traders_.end(),
+    std::set<Trader*, trader_compare> bidders;
+    InitBidders(bidders);
+    std::for_each(bidders.begin(),
+                  bidders.end(),
                   std::bind(&cyclus::ResourceExchange<T>::AddBids_,
                             this,
                             std::placeholders::_1));
@@ -99,22 +107,69 @@ template <class T> class ResourceExchange {
 
   /// return true if this is an empty exchange (i.e., no requests exist,
   /// therefore no bids)
-  inline bool Empty() { return ex_ctx_.bids_by_request.empty(); }
+  inline bool Empty() { return ex_ctx_.bids_by_id.empty(); }
 
  private:
+  struct trader_compare {
+    bool operator()(Trader* lhs, Trader* rhs) const {
+      int left = lhs->manager()->id();
+      int right = rhs->manager()->id();
+      if (left != right) {
+        return left < right;
+      } else {
+        return lhs < rhs;
+      }
+    }
+  };
+
+  /// collects the traders of all agents that are not asleep
   void InitTraders() {
     if (traders_.size() == 0) {
       std::set<Trader*> orig = sim_ctx_->traders();
       std::set<Trader*>::iterator it;
       for (it = orig.begin(); it != orig.end(); ++it) {
-        traders_.insert(*it);
+        if (!sim_ctx_->IsAsleep((*it)->manager())) {
+          traders_.insert(*it);
+        }
+      }
+    }
+  }
+
+  /// collects the traders that are not asleep and either supply a requested
+  /// commodity or did not declare which commodities they supply
+  void InitBidders(std::set<Trader*, trader_compare>& bidders) {
+    const std::set<Trader*>& undeclared = sim_ctx_->undeclared_traders();
+    std::set<Trader*>::const_iterator it;
+    for (it = undeclared.begin(); it != undeclared.end(); ++it) {
+      if (traders_.count(*it) > 0) {
+        bidders.insert(*it);
+      }
+    }
+
+    typename CommodMap<T>::type::iterator cit;
+    for (cit = ex_ctx_.commod_requests.begin();
+         cit != ex_ctx_.commod_requests.end(); ++cit) {
+      const std::set<Trader*>& suppliers =
+          sim_ctx_->commod_suppliers(cit->first);
+      for (it = suppliers.begin(); it != suppliers.end(); ++it) {
+        if (traders_.count(*it) > 0) {
+          bidders.insert(*it);
+        }
       }
     }
   }
 
   /// @brief queries a given facility agent for
   void AddRequests_(Trader* t) {
-    std::set<typename RequestPortfolio<T>::Ptr> rp = QueryRequests<T>(t);
+    std::set<typename RequestPortfolio<T>::Ptr> rp;
+    if (prof_ == NULL) {
+      rp = QueryRequests<T>(t);
+    } else {
+      double start = AgentProfiler::Now();
+      rp = QueryRequests<T>(t);
+      prof_->Add(t->manager(), ExchangePhases<T>::kRequests,
+                 AgentProfiler::Now() - start);
+    }
     typename std::set<typename RequestPortfolio<T>::Ptr>::iterator it;
     for (it = rp.begin(); it != rp.end(); ++it) {
       ex_ctx_.AddRequestPortfolio(*it);
@@ -123,8 +178,15 @@ template <class T> class ResourceExchange {
 
   /// @brief queries a given facility agent for
   void AddBids_(Trader* t) {
-    std::set<typename BidPortfolio<T>::Ptr> bp =
-        QueryBids<T>(t, ex_ctx_.commod_requests);
+    std::set<typename BidPortfolio<T>::Ptr> bp;
+    if (prof_ == NULL) {
+      bp = QueryBids<T>(t, ex_ctx_.commod_requests);
+    } else {
+      double start = AgentProfiler::Now();
+      bp = QueryBids<T>(t, ex_ctx_.commod_requests);
+      prof_->Add(t->manager(), ExchangePhases<T>::kBids,
+                 AgentProfiler::Now() - start);
+    }
     typename std::set<typename BidPortfolio<T>::Ptr>::iterator it;
     for (it = bp.begin(); it != bp.end(); ++it) {
       ex_ctx_.AddBidPortfolio(*it);
@@ -134,27 +196,16 @@ template <class T> class ResourceExchange {
   /// @brief allows a trader and its parents to adjust any preferences in the
   /// system
   void AdjustPrefs_(Trader* t) {
-    typename PrefMap<T>::type& prefs = ex_ctx_.trader_prefs[t];
+    PrefMap<T> prefs = ex_ctx_.trader_prefs(t);
     AdjustPrefs(t, prefs);
     Agent* m = t->manager()->parent();
     while (m != NULL) {
       AdjustPrefs(m, prefs);
       m = m->parent();
     }
+    prefs.Sync();
   }
 
-  struct trader_compare {
-    bool operator()(Trader* lhs, Trader* rhs) const {
-      int left = lhs->manager()->id();
-      int right = rhs->manager()->id();
-      if (left != right) {
-        return left < right;
-      } else {
-        return lhs < rhs;
-      }
-    }
-  };
-
   // this sorts traders (and results in iteration...) based on traders'
   // manager id.  Iterating over traders in this order helps increase the
   // determinism of Cyclus overall.  This allows all traders' resource
@@ -162,6 +213,7 @@ template <class T> class ResourceExchange {
   std::set<Trader*, trader_compare> traders_;
 
   Context* sim_ctx_;
+  AgentProfiler* prof_;
   ExchangeContext<T> ex_ctx_;
 };
 
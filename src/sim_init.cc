@@ -1,7 +1,10 @@
 #include "sim_init.h"
 
+#include <cstring>
+
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
+#include "mem_back.h"
 #include "platform.h"
 #include "prog_solver.h"
 #include "region.h"
@@ -14,6 +17,20 @@ class Dummy : public Region {
   Dummy* Clone() { return NULL; }
 };
 
+SnapshotCache::SnapshotCache() : scratch_(false) {
+  scratch_.RegisterBackend(this);
+}
+
+void SnapshotCache::Notify(DatumList data) {
+  for (int i = 0; i < data.size(); ++i) {
+    Row row;
+    row.title = data[i]->title();
+    row.vals = data[i]->vals();
+    row.shapes = data[i]->shapes();
+    pending_.push_back(row);
+  }
+}
+
 SimInit::SimInit() : rec_(NULL), ctx_(NULL) {}
 
 SimInit::~SimInit() {
@@ -53,7 +70,16 @@ void SimInit::InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t) {
 
   std::vector<Cond> conds;
   conds.push_back(Cond("SimId", "==", simid));
-  b_ = new CondInjector(b, conds);
+  CondInjector ci(b, conds);
+
+  // each table is read once and the per agent and per resource lookups below
+  // are served from memory. Agent state recorded after t is never needed.
+  QueryCache cache(&ci);
+  conds.clear();
+  conds.push_back(Cond("SimTime", "<=", t));
+  cache.Restrict("AgentState", conds);
+
+  b_ = &cache;
   t_ = t;
   simid_ = simid;
 
@@ -69,22 +95,41 @@ void SimInit::InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t) {
   LoadBuildSched();
   LoadDecomSched();
   LoadNextIds();
+  b_ = NULL;
 
   // delete all buffered data that we don't want to be re-recorded in the
   // output db
   rec_->Flush();
 }
 
-void SimInit::Snapshot(Context* ctx) {
+void SimInit::Snapshot(Context* ctx, SnapshotCache* cache) {
   ctx->NewDatum("Snapshots")->AddVal("Time", ctx->time())->Record();
 
   // snapshot all agent internal state
+  std::set<int> alive;
   std::set<Agent*> mlist = ctx->agent_list_;
   std::set<Agent*>::iterator it;
   for (it = mlist.begin(); it != mlist.end(); ++it) {
     Agent* m = *it;
-    if (m->enter_time() != -1) {
+    if (m->enter_time() == -1) {
+      continue;
+    } else if (cache == NULL) {
       SimInit::SnapAgent(m);
+    } else {
+      SimInit::SnapAgent(m, cache);
+      alive.insert(m->id());
+    }
+  }
+
+  // forget the state of agents that have been decommissioned
+  if (cache != NULL) {
+    std::map<int, std::vector<SnapshotCache::Row> >::iterator rit;
+    for (rit = cache->rows_.begin(); rit != cache->rows_.end();) {
+      if (alive.count(rit->first) == 0) {
+        cache->rows_.erase(rit++);
+      } else {
+        ++rit;
+      }
     }
   }
 
@@ -145,6 +190,52 @@ void SimInit::SnapAgent(Agent* m) {
   }
 }
 
+bool SimInit::SnapAgent(Agent* m, SnapshotCache* cache) {
+  // record the agent's state to the cache's scratch recorder first
+  Context* ctx = m->context();
+  Recorder* rec = ctx->rec_;
+  ctx->rec_ = &cache->scratch_;
+  try {
+    SnapAgent(m);
+    cache->scratch_.Flush();
+  } catch (...) {
+    ctx->rec_ = rec;
+    cache->pending_.clear();
+    throw;
+  }
+  ctx->rec_ = rec;
+
+  // the state is unchanged if every row has the same values as in the
+  // previous snapshot, except for the time it was taken
+  std::vector<SnapshotCache::Row>& prev = cache->rows_[m->id()];
+  std::vector<SnapshotCache::Row>& rows = cache->pending_;
+  bool changed = prev.size() != rows.size();
+  for (int i = 0; i < rows.size() && !changed; ++i) {
+    const Datum::Vals& a = prev[i].vals;
+    const Datum::Vals& b = rows[i].vals;
+    changed = prev[i].title != rows[i].title || a.size() != b.size();
+    for (int j = 0; j < b.size() && !changed; ++j) {
+      changed = std::strcmp(a[j].first, b[j].first) != 0 ||
+                (std::strcmp(b[j].first, "SimTime") != 0 &&
+                 !ValuesEqual(a[j].second, b[j].second));
+    }
+  }
+
+  if (changed) {
+    for (int i = 0; i < rows.size(); ++i) {
+      Datum* d = ctx->NewDatum(rows[i].title);
+      for (int j = 0; j < rows[i].vals.size(); ++j) {
+        d->AddVal(rows[i].vals[j].first, rows[i].vals[j].second,
+                  &rows[i].shapes[j]);
+      }
+      d->Record();
+    }
+    prev.swap(rows);
+  }
+  rows.clear();
+  return changed;
+}
+
 void SimInit::LoadInfo() {
   QueryResult qr = b_->Query("Info", NULL);
   int dur = qr.GetVal<int>("Duration");
@@ -173,6 +264,20 @@ void SimInit::LoadInfo() {
   si_.explicit_inventory = qr.GetVal<bool>("RecordInventory");
   si_.explicit_inventory_compact = qr.GetVal<bool>("RecordInventoryCompact");
 
+  try {
+    qr = b_->Query("InfoInventory", NULL);
+    si_.explicit_inventory_interval = qr.GetVal<int>("Interval");
+    si_.explicit_inventory_incremental = qr.GetVal<bool>("Incremental");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoSnapshots", NULL);
+    si_.snapshot_interval = qr.GetVal<int>("Interval");
+    si_.snapshot_incremental = qr.GetVal<bool>("Incremental");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
   ctx_->InitSim(si_);
 }
 
@@ -384,6 +489,21 @@ void SimInit::LoadInitialAgents() {
   // to be done once; remember that we are initializing agents from a
   // simulation that was already started.
 
+  // agents are restored from their latest snapshot at or before t_, which is
+  // older than t_ for agents whose state did not change in incremental
+  // snapshots. Every snapshot of an agent records its AgentStateAgent row.
+  try {
+    QueryResult qsnap = b_->Query("AgentStateAgent", NULL);
+    for (int i = 0; i < qsnap.rows.size(); ++i) {
+      int id = qsnap.GetVal<int>("AgentId", i);
+      int t = qsnap.GetVal<int>("SimTime", i);
+      if (t <= t_ && (snap_times_.count(id) == 0 || t > snap_times_[id])) {
+        snap_times_[id] = t;
+      }
+    }
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
   // find all agents that are alive at the current timestep
   std::vector<Cond> conds;
   conds.push_back(Cond("EnterTime", "<=", t_));
@@ -423,7 +543,7 @@ void SimInit::LoadInitialAgents() {
 
     // agent-custom init
     conds.pop_back();
-    conds.push_back(Cond("SimTime", "==", t_));
+    conds.push_back(Cond("SimTime", "==", SnapTime(id)));
     CondInjector ci(b_, conds);
     PrefixInjector pi(&ci, "AgentState");
     m->Agent::InitFrom(&pi);
@@ -471,7 +591,7 @@ void SimInit::LoadInventories() {
   for (it = agents_.begin(); it != agents_.end(); ++it) {
     Agent* m = it->second;
     std::vector<Cond> conds;
-    conds.push_back(Cond("SimTime", "==", t_));
+    conds.push_back(Cond("SimTime", "==", SnapTime(m->id())));
     conds.push_back(Cond("AgentId", "==", m->id()));
     QueryResult qr;
     try {
@@ -490,6 +610,11 @@ void SimInit::LoadInventories() {
   }
 }
 
+int SimInit::SnapTime(int agentid) {
+  std::map<int, int>::iterator it = snap_times_.find(agentid);
+  return it == snap_times_.end() ? t_ : it->second;
+}
+
 void SimInit::LoadBuildSched() {
   std::vector<Cond> conds;
   conds.push_back(Cond("BuildTime", ">", t_));
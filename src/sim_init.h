@@ -7,11 +7,49 @@
 #include "context.h"
 #include "timer.h"
 #include "recorder.h"
+#include "rec_backend.h"
 
 namespace cyclus {
 
 class Context;
 
+/// Keeps the rows recorded for each agent by the previous incremental snapshot
+/// (see SimInit::Snapshot), so that agents whose state has not changed since
+/// then are not recorded again.
+class SnapshotCache : private RecBackend {
+ public:
+  SnapshotCache();
+
+  /// Forgets all agent state, so that the next snapshot records every agent.
+  void Clear() { rows_.clear(); }
+
+ private:
+  friend class SimInit;
+
+  /// A recorded row of agent state.
+  struct Row {
+    std::string title;
+    Datum::Vals vals;
+    Datum::Shapes shapes;
+  };
+
+  /// Collects the rows recorded to scratch_.
+  virtual void Notify(DatumList data);
+  virtual std::string Name() { return "SnapshotCache"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  // std::map<AgentId, rows>
+  std::map<int, std::vector<Row> > rows_;
+
+  /// rows of the agent being snapshotted
+  std::vector<Row> pending_;
+
+  /// recorder that agent state is snapshotted to before being compared, it
+  /// must be destroyed first because it notifies this on destruction
+  Recorder scratch_;
+};
+
 /// Handles initialization of a simulation from the output database. After
 /// calling Init, Restart, or Branch, the initialized Context, Timer, and
 /// Recorder can be retrieved.
@@ -46,13 +84,23 @@ class SimInit {
 
   /// Records a snapshot of the current state of the simulation being managed by
   /// ctx into the simulation's output database.
-  static void Snapshot(Context* ctx);
+  ///
+  /// If cache is not NULL the snapshot is incremental: the state of an agent
+  /// is only recorded if it differs from the state it had in the previous
+  /// snapshot taken with the same cache. Restarting from an incremental
+  /// snapshot restores each agent from its latest recorded state.
+  static void Snapshot(Context* ctx, SnapshotCache* cache = NULL);
 
   /// Records a snapshot of the agent's current internal state into the
   /// simulation's output database.  Note that this should generally not be
   /// called directly.
   static void SnapAgent(Agent* m);
 
+  /// Records a snapshot of the agent's current internal state into the
+  /// simulation's output database if it has changed since it was last
+  /// recorded to cache. Returns whether the state was recorded.
+  static bool SnapAgent(Agent* m, SnapshotCache* cache);
+
   /// Returns the initialized context. Note that either Init, Restart, or Branch
   /// must be called first.
   Context* context() { return ctx_; }
@@ -90,6 +138,9 @@ class SimInit {
   void LoadDecomSched();
   void LoadNextIds();
 
+  /// Returns the time of the latest snapshot of an agent at or before t_.
+  int SnapTime(int agentid);
+
   void* LoadPreconditioner(std::string name);
   ExchangeSolver* LoadGreedySolver(
       bool exclusive, std::set<std::string> tables);
@@ -104,6 +155,9 @@ class SimInit {
   // std::map<AgentId, Agent*>
   std::map<int, Agent*> agents_;
 
+  // std::map<AgentId, time of the agent's latest snapshot at or before t_>
+  std::map<int, int> snap_times_;
+
   Context* ctx_;
   Recorder* rec_;
   Timer ti_;
@@ -0,0 +1,107 @@
+#include "tick_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "agent.h"
+#include "env.h"
+#include "error.h"
+#include "time_listener.h"
+
+namespace cyclus {
+
+// weight of the latest measured time in a listener's expected time
+static const double kCostWeight = 0.5;
+
+/// Orders listener indices by descending expected cost, and then by index so
+/// that the order does not depend on listener addresses.
+struct DescendingCost {
+  const std::vector<double>* costs;
+  bool operator()(int a, int b) const {
+    if ((*costs)[a] != (*costs)[b])
+      return (*costs)[a] > (*costs)[b];
+    return a < b;
+  }
+};
+
+TickScheduler::Policy TickScheduler::ParsePolicy(std::string name) {
+  if (name == "static") {
+    return STATIC;
+  } else if (name == "cost") {
+    return COST;
+  }
+  throw ValueError("unknown tick schedule '" + name +
+                   "', must be 'static' or 'cost'");
+}
+
+TickScheduler::Policy TickScheduler::EnvPolicy() {
+  std::string name = Env::GetEnv("CYCLUS_TICK_SCHEDULE");
+  return name.empty() ? STATIC : ParsePolicy(name);
+}
+
+double TickScheduler::cost(TimeListener* l) const {
+  std::map<TimeListener*, double>::const_iterator it = costs_.find(l);
+  return it == costs_.end() ? -1 : it->second;
+}
+
+void TickScheduler::Run(const std::vector<TimeListener*>& listeners,
+                        void (TimeListener::*phase)(), AgentProfiler* prof,
+                        AgentProfiler::Phase prof_phase) {
+  int n = listeners.size();
+  if (policy_ == STATIC && prof == NULL) {
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+      (listeners[i]->*phase)();
+    }
+    return;
+  } else if (policy_ == STATIC) {
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+      double start = AgentProfiler::Now();
+      (listeners[i]->*phase)();
+      prof->Add(dynamic_cast<Agent*>(listeners[i]), prof_phase,
+                AgentProfiler::Now() - start);
+    }
+    return;
+  }
+
+  // unmeasured listeners go first, since they may be the most expensive
+  std::vector<double> expected(n);
+  double most = 0;
+  for (int i = 0; i < n; ++i) {
+    expected[i] = cost(listeners[i]);
+    most = std::max(most, expected[i]);
+  }
+  order_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    order_[i] = i;
+    if (expected[i] < 0)
+      expected[i] = 2 * most + 1;
+  }
+  DescendingCost cmp = {&expected};
+  std::sort(order_.begin(), order_.end(), cmp);
+
+  times_.resize(n);
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int k = 0; k < n; ++k) {
+    int i = order_[k];
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    (listeners[i]->*phase)();
+    times_[i] = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+  }
+
+  for (int i = 0; i < n; ++i) {
+    std::map<TimeListener*, double>::iterator it = costs_.find(listeners[i]);
+    if (it == costs_.end()) {
+      costs_[listeners[i]] = times_[i];
+    } else {
+      it->second += kCostWeight * (times_[i] - it->second);
+    }
+    if (prof != NULL)
+      prof->Add(dynamic_cast<Agent*>(listeners[i]), prof_phase, times_[i]);
+  }
+}
+
+}  // namespace cyclus
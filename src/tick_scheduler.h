@@ -0,0 +1,78 @@
+#ifndef CYCLUS_SRC_TICK_SCHEDULER_H_
+#define CYCLUS_SRC_TICK_SCHEDULER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "agent_profiler.h"
+
+namespace cyclus {
+
+class TimeListener;
+
+/// Notifies C++ time listeners of one phase of a time step (e.g. Tick or
+/// Tock), in parallel when cyclus is built with OpenMP.
+///
+/// With the STATIC policy listeners are split into equal-count blocks in
+/// registration order, one per thread. Because a few agents often do most of
+/// the work in a phase, this can leave all but one thread idle. With the COST
+/// policy the time each listener takes is measured and remembered, listeners
+/// are notified in order of descending expected time, and idle threads take
+/// the next listener from the shared order as soon as they are done with
+/// their previous one. Listeners without a measured time are notified first.
+class TickScheduler {
+ public:
+  /// How listeners are distributed over threads.
+  enum Policy {
+    STATIC,
+    COST,
+  };
+
+  /// Returns the policy named "static" or "cost".
+  /// @throws ValueError if name is not a policy
+  static Policy ParsePolicy(std::string name);
+
+  /// Returns the policy set by the CYCLUS_TICK_SCHEDULE environment variable,
+  /// which is STATIC if it is unset.
+  static Policy EnvPolicy();
+
+  TickScheduler(Policy p = STATIC) : policy_(p) {}
+
+  /// Calls phase for each listener. If prof is not NULL, the time each
+  /// listener takes is added to it as prof_phase.
+  void Run(const std::vector<TimeListener*>& listeners,
+           void (TimeListener::*phase)(), AgentProfiler* prof = NULL,
+           AgentProfiler::Phase prof_phase = AgentProfiler::TICK);
+
+  /// Forgets the measured time of a listener, e.g. once it is unregistered,
+  /// so that a new listener at the same address starts unmeasured.
+  void Forget(TimeListener* l) { costs_.erase(l); }
+
+  /// Forgets the measured time of all listeners.
+  void Clear() { costs_.clear(); }
+
+  /// Returns the expected time in seconds the listener takes for the phase,
+  /// or a negative number if it has not been measured yet.
+  double cost(TimeListener* l) const;
+
+  inline Policy policy() const { return policy_; }
+  inline void policy(Policy p) { policy_ = p; }
+
+ private:
+  Policy policy_;
+
+  /// expected time in seconds of each listener, an exponentially weighted
+  /// average of its measured times
+  std::map<TimeListener*, double> costs_;
+
+  /// listener indices in the order they are notified
+  std::vector<int> order_;
+
+  /// measured times of the current run, by listener index
+  std::vector<double> times_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_TICK_SCHEDULER_H_
@@ -43,6 +43,14 @@ class TimeListener : virtual public Ider {
   /// @param time is the current simulation timestep
   virtual void Decision() {};
 
+  /// Returns true if the Decision method may run concurrently with the
+  /// Decision method of other listeners. Such a Decision must only modify its
+  /// own agent, and may schedule builds and decommissionings through the
+  /// context, which take effect in listener id order once all concurrent
+  /// decisions are done. Listeners that return false decide one at a time
+  /// afterwards.
+  virtual bool ParallelDecision() { return false; };
+
   virtual bool IsShim() { return true; };
 };
 
@@ -12,6 +12,7 @@
 #endif  // CYCLUS_IS_PARALLEL
 
 #include "agent.h"
+#include "env.h"
 #include "error.h"
 #include "logger.h"
 #include "pyhooks.h"
@@ -40,9 +41,18 @@ void Timer::RunSim() {
   while (time_ < si_.duration) {
     CLOG(LEV_INFO1) << "Current time: " << time_;
 
-    if (want_snapshot_) {
+    WakeDue();
+    if (Idle()) {
+      SkipIdleSteps();
+      if (want_kill_) {
+        break;
+      }
+      continue;
+    }
+
+    if (SnapshotDue()) {
       want_snapshot_ = false;
-      SimInit::Snapshot(ctx_);
+      DoSnapshot();
     }
 
     // run through phases
@@ -56,11 +66,16 @@ void Timer::RunSim() {
     CLOG(LEV_INFO2) << "Beginning Decision for time: " << time_;
     DoDecision();
     DoDecom();
+    toolkit::PyFlushListeners();
 
 #ifdef CYCLUS_WITH_PYTHON
     EventLoop();
 #endif
 
+    if (profiler_ != nullptr) {
+      profiler_->EndStep(time_);
+    }
+
     time_++;
     RedrawProgressBar();
 
@@ -70,29 +85,151 @@ void Timer::RunSim() {
     }
   }
 
+  // values recorded in idle steps or outside of the time step phases
+  toolkit::PyFlushListeners();
+
   ctx_->NewDatum("Finish")
       ->AddVal("EarlyTerm", want_kill_)
       ->AddVal("EndTime", time_ - 1)
       ->Record();
 
-  SimInit::Snapshot(
-      ctx_);  // always do a snapshot at the end of every simulation
+  DoSnapshot();  // always do a snapshot at the end of every simulation
+
+  if (profiler_ != nullptr) {
+    profiler_->Flush();
+    if (!quiet_) {
+      profiler_->PrintSummary(std::cout);
+    }
+  }
 
   if (quiet_) {
     Logger::SetReportLevel(saved_level);
   }
 }
 
+bool Timer::SnapshotDue() {
+  return want_snapshot_ || (si_.snapshot_interval > 0 && time_ > 0 &&
+                            time_ % si_.snapshot_interval == 0);
+}
+
+bool Timer::Idle() {
+  UpdateAwake();
+  if (!awake_cpp_.empty() || !awake_py_.empty() || SnapshotDue() ||
+      InventoryDue()) {
+    return false;
+  }
+
+  std::map<int, std::vector<std::pair<std::string, Agent*>>>::iterator bit =
+      build_queue_.find(time_);
+  std::map<int, std::list<Agent*>>::iterator dit = decom_queue_.find(time_);
+  if ((bit != build_queue_.end() && !bit->second.empty()) ||
+      (dit != decom_queue_.end() && !dit->second.empty())) {
+    return false;
+  }
+
+  // traders that do not listen for ticks may still trade
+  const std::set<Trader*>& traders = ctx_->traders();
+  std::set<Trader*>::const_iterator it;
+  for (it = traders.begin(); it != traders.end(); ++it) {
+    if (!ctx_->IsAsleep((*it)->manager())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Timer::SkipIdleSteps() {
+  // the next time step that anything happens at
+  int next = si_.duration;
+  if (!wake_queue_.empty()) {
+    next = std::min(next, wake_queue_.begin()->first);
+  }
+  std::map<int, std::vector<std::pair<std::string, Agent*>>>::iterator bit;
+  for (bit = build_queue_.upper_bound(time_); bit != build_queue_.end();
+       ++bit) {
+    if (!bit->second.empty()) {
+      next = std::min(next, bit->first);
+      break;
+    }
+  }
+  std::map<int, std::list<Agent*>>::iterator dit;
+  for (dit = decom_queue_.upper_bound(time_); dit != decom_queue_.end();
+       ++dit) {
+    if (!dit->second.empty()) {
+      next = std::min(next, dit->first);
+      break;
+    }
+  }
+  if (si_.snapshot_interval > 0) {
+    next = std::min(next, (time_ / si_.snapshot_interval + 1) *
+                              si_.snapshot_interval);
+  }
+  if ((si_.explicit_inventory || si_.explicit_inventory_compact) &&
+      si_.explicit_inventory_interval > 1) {
+    next = std::min(next, (time_ / si_.explicit_inventory_interval + 1) *
+                              si_.explicit_inventory_interval);
+  }
+
+  CLOG(LEV_INFO2) << "Skipping idle time steps " << time_ << " to "
+                  << next - 1;
+  ctx_->NewDatum("SkippedSteps")
+      ->AddVal("StartTime", time_)
+      ->AddVal("EndTime", next - 1)
+      ->Record();
+
+  // profiling windows span the skipped steps as if they had been run
+  if (profiler_ != nullptr) {
+    for (int t = time_; t < next; ++t) {
+      profiler_->EndStep(t);
+    }
+  }
+
+#ifdef CYCLUS_WITH_PYTHON
+  EventLoop();
+#endif
+
+  // materials decay lazily from the time they last decayed, so the skipped
+  // steps are accounted for the next time they are accessed
+  time_ = next;
+  RedrawProgressBar();
+}
+
 void Timer::DoBuild() {
   // build queued agents
-  std::vector<std::pair<std::string, Agent*>> build_list = build_queue_[time_];
+  std::map<int, std::vector<std::pair<std::string, Agent*>>>::iterator it =
+      build_queue_.find(time_);
+  if (it == build_queue_.end()) {
+    return;
+  }
+  std::vector<std::pair<std::string, Agent*>> build_list = it->second;
+
+  // agents are cloned in parallel only when asked to and there is more than
+  // one thread to do it; otherwise each agent is cloned, built and announced
+  // to its parent before the next one is cloned
+  bool batch = parallel_builds_ && build_list.size() > 1;
+#if CYCLUS_IS_PARALLEL
+  batch = batch && omp_get_max_threads() > 1;
+#else
+  batch = false;
+#endif  // CYCLUS_IS_PARALLEL
+
+  std::vector<Agent*> built;
+  if (batch) {
+    std::vector<std::string> protos(build_list.size());
+    for (int i = 0; i < build_list.size(); ++i) {
+      protos[i] = build_list[i].first;
+    }
+    built = ctx_->CreateAgents(protos, true);
+  }
+
   for (int i = 0; i < build_list.size(); ++i) {
-    Agent* m = ctx_->CreateAgent<Agent>(build_list[i].first);
+    Agent* m = batch ? built[i] : ctx_->CreateAgent<Agent>(build_list[i].first);
     Agent* parent = build_list[i].second;
     CLOG(LEV_INFO3) << "Building a " << build_list[i].first << " from parent "
                     << build_list[i].second;
     m->Build(parent);
     if (parent != NULL) {
+      Wake(parent->id());
       parent->BuildNotify(m);
     } else {
       CLOG(LEV_DEBUG1) << "Hey! Listen! Built an Agent without a Parent.";
@@ -101,14 +238,21 @@ void Timer::DoBuild() {
 }
 
 void Timer::DoTick() {
-  for (TimeListener* agent : py_tickers_) {
-    agent->Tick();
+  UpdateAwake();
+  AgentProfiler* prof = profiler_.get();
+  for (TimeListener* agent : awake_py_) {
+    if (prof == NULL) {
+      agent->Tick();
+    } else {
+      double start = AgentProfiler::Now();
+      agent->Tick();
+      prof->Add(dynamic_cast<Agent*>(agent), AgentProfiler::TICK,
+                AgentProfiler::Now() - start);
+    }
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < cpp_tickers_.size(); ++i) {
-    cpp_tickers_[i]->Tick();
-  }
+  tick_sched_.Run(awake_cpp_, &TimeListener::Tick, prof,
+                  AgentProfiler::TICK);
 }
 
 void Timer::DoResEx(ExchangeManager<Material>* matmgr,
@@ -118,80 +262,314 @@ void Timer::DoResEx(ExchangeManager<Material>* matmgr,
 }
 
 void Timer::DoTock() {
-  for (TimeListener* agent : py_tickers_) {
-    agent->Tock();
+  UpdateAwake();
+  AgentProfiler* prof = profiler_.get();
+  for (TimeListener* agent : awake_py_) {
+    if (prof == NULL) {
+      agent->Tock();
+    } else {
+      double start = AgentProfiler::Now();
+      agent->Tock();
+      prof->Add(dynamic_cast<Agent*>(agent), AgentProfiler::TOCK,
+                AgentProfiler::Now() - start);
+    }
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < cpp_tickers_.size(); ++i) {
-    cpp_tickers_[i]->Tock();
-  }
+  tock_sched_.Run(awake_cpp_, &TimeListener::Tock, prof,
+                  AgentProfiler::TOCK);
 
   if (si_.explicit_inventory || si_.explicit_inventory_compact) {
-    std::set<Agent*> ags = ctx_->agent_list_;
-    std::vector<Agent*> agent_vec(ags.begin(), ags.end());
-#pragma omp parallel for
-    for (int i = 0; i < agent_vec.size(); i++) {
-      Agent* a = agent_vec[i];
-      if (a->enter_time() != -1) {
-        RecordInventories(a);
-      }
-    }
+    RecordInventories();
   }
 }
 
 void Timer::DoDecision() {
+  AgentProfiler* prof = profiler_.get();
+  std::vector<TimeListener*> par;
+  std::vector<TimeListener*> ser;
   for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
        agent != tickers_.end();
        agent++) {
-    agent->second->Decision();
+    if (!sleepers_.empty() && sleepers_.count(agent->first) > 0) {
+      continue;
+    }
+    if (agent->second->ParallelDecision()) {
+      par.push_back(agent->second);
+    } else {
+      ser.push_back(agent->second);
+    }
+  }
+
+  if (!par.empty()) {
+#if CYCLUS_IS_PARALLEL
+    int nthreads = omp_get_max_threads();
+#else
+    int nthreads = 1;
+#endif  // CYCLUS_IS_PARALLEL
+    deciding_.assign(nthreads, -1);
+    deferred_.assign(nthreads, std::vector<DeferredSched>());
+    deferring_ = true;
+    int n = par.size();
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+#if CYCLUS_IS_PARALLEL
+      deciding_[omp_get_thread_num()] = i;
+#else
+      deciding_[0] = i;
+#endif  // CYCLUS_IS_PARALLEL
+      if (prof == NULL) {
+        par[i]->Decision();
+      } else {
+        double start = AgentProfiler::Now();
+        par[i]->Decision();
+        prof->Add(dynamic_cast<Agent*>(par[i]), AgentProfiler::DECISION,
+                  AgentProfiler::Now() - start);
+      }
+    }
+    deferring_ = false;
+    SchedDeferred();
+  }
+
+  for (int i = 0; i < ser.size(); ++i) {
+    if (prof == NULL) {
+      ser[i]->Decision();
+    } else {
+      double start = AgentProfiler::Now();
+      ser[i]->Decision();
+      prof->Add(dynamic_cast<Agent*>(ser[i]), AgentProfiler::DECISION,
+                AgentProfiler::Now() - start);
+    }
+  }
+}
+
+void Timer::SchedDeferred() {
+  // each listener ran on one thread, so a stable sort keeps the order in
+  // which it scheduled
+  std::vector<DeferredSched> all;
+  for (int i = 0; i < deferred_.size(); ++i) {
+    all.insert(all.end(), deferred_[i].begin(), deferred_[i].end());
+  }
+  deferred_.clear();
+  std::stable_sort(all.begin(), all.end(),
+                   [](const DeferredSched& a, const DeferredSched& b) {
+                     return a.pos < b.pos;
+                   });
+
+  for (int i = 0; i < all.size(); ++i) {
+    if (all[i].build) {
+      ctx_->SchedBuild(all[i].agent, all[i].proto_name, all[i].t);
+    } else {
+      ctx_->SchedDecom(all[i].agent, all[i].t);
+    }
+  }
+}
+
+void Timer::DoSnapshot() {
+  if (!si_.snapshot_incremental) {
+    SimInit::Snapshot(ctx_);
+    return;
+  }
+
+  // every snapshot must go through the cache, otherwise an agent could be
+  // skipped because it has the state it had before a snapshot the cache
+  // did not see
+  if (snap_cache_ == nullptr) {
+    snap_cache_.reset(new SnapshotCache());
+  }
+  SimInit::Snapshot(ctx_, snap_cache_.get());
+}
+
+/// Orders agents by id.
+static bool LessId(Agent* a, Agent* b) {
+  return a->id() < b->id();
+}
+
+bool Timer::InventoryDue() {
+  if (!si_.explicit_inventory && !si_.explicit_inventory_compact) {
+    return false;
+  }
+  return si_.explicit_inventory_interval <= 1 ||
+         time_ % si_.explicit_inventory_interval == 0;
+}
+
+void Timer::RecordInventories() {
+  if (!InventoryDue()) {
+    return;
+  }
+
+  std::vector<Agent*> agents;
+  std::set<Agent*>::iterator it;
+  for (it = ctx_->agent_list_.begin(); it != ctx_->agent_list_.end(); ++it) {
+    if ((*it)->enter_time() != -1) {
+      agents.push_back(*it);
+    }
+  }
+  // rows are recorded in the same order in every run
+  std::sort(agents.begin(), agents.end(), LessId);
+
+  // the previous inventories of each agent are looked up before summing in
+  // parallel, which also forgets those of decommissioned agents
+  std::vector<std::map<std::string, RecordedInventory>*> prev(agents.size());
+  if (si_.explicit_inventory_incremental) {
+    std::map<int, std::map<std::string, RecordedInventory>> recorded;
+    for (int i = 0; i < agents.size(); ++i) {
+      std::map<std::string, RecordedInventory>& p = recorded[agents[i]->id()];
+      p.swap(recorded_invs_[agents[i]->id()]);
+    }
+    recorded_invs_.swap(recorded);
+    for (int i = 0; i < agents.size(); ++i) {
+      prev[i] = &recorded_invs_[agents[i]->id()];
+    }
+  }
+
+  std::vector<std::vector<InventorySum>> sums(agents.size());
+#pragma omp parallel for
+  for (int i = 0; i < agents.size(); i++) {
+    SumInventories(agents[i], prev[i], &sums[i]);
+  }
+
+  for (int i = 0; i < agents.size(); i++) {
+    for (int j = 0; j < sums[i].size(); j++) {
+      RecordInventory(agents[i], sums[i][j]);
+    }
   }
 }
 
-void Timer::RecordInventories(Agent* a) {
+void Timer::SumInventories(Agent* a,
+                           std::map<std::string, RecordedInventory>* prev,
+                           std::vector<InventorySum>* sums) {
+  bool lazy = si_.decay == "lazy";
   Inventories invs = a->SnapshotInv();
-  Inventories::iterator it2;
-  for (it2 = invs.begin(); it2 != invs.end(); ++it2) {
-    std::string name = it2->first;
-    std::vector<Resource::Ptr> mats = it2->second;
-    if (mats.empty() || ResCast<Material>(mats[0]) == NULL) {
-      continue;  // skip non-material inventories
+  std::set<std::string> held;
+  Inventories::iterator it;
+  for (it = invs.begin(); it != invs.end(); ++it) {
+    const std::vector<Resource::Ptr>& rs = it->second;
+    if (rs.empty() || ResCast<Material>(rs[0]) == NULL) {
+      continue;  // skip empty and non-material inventories
+    }
+    held.insert(it->first);
+
+    // reading the composition of a material decays it in lazy decay mode,
+    // which must only happen to a copy of a material in an inventory
+    std::vector<Material::Ptr> mats(rs.size());
+    std::vector<Composition::Ptr> comps(rs.size());
+    for (int i = 0; i < rs.size(); i++) {
+      mats[i] = ResCast<Material>(rs[i]);
+      comps[i] = lazy ? ResCast<Material>(mats[i]->Clone())->comp()
+                      : mats[i]->comp();
+    }
+
+    if (prev != NULL) {
+      InventoryItems items(mats.size());
+      for (int i = 0; i < mats.size(); i++) {
+        items[i].state_id = mats[i]->state_id();
+        items[i].comp_id = comps[i]->id();
+        items[i].qty = mats[i]->quantity();
+      }
+      InventoryItems& p = (*prev)[it->first].items;
+      if (p == items) {
+        continue;
+      }
+      p.swap(items);
+    }
+
+    // materials often share a composition, which is then only scaled once
+    std::map<int, std::pair<Composition::Ptr, double>> by_comp;
+    InventorySum sum;
+    sum.name = it->first;
+    sum.units = mats[0]->units();
+    sum.qty = 0;
+    for (int i = 0; i < mats.size(); i++) {
+      std::pair<Composition::Ptr, double>& c = by_comp[comps[i]->id()];
+      c.first = comps[i];
+      c.second += mats[i]->quantity();
+      sum.qty += mats[i]->quantity();
+    }
+
+    std::map<int, std::pair<Composition::Ptr, double>>::iterator cit;
+    for (cit = by_comp.begin(); cit != by_comp.end(); ++cit) {
+      CompMap v = cit->second.first->mass();
+      compmath::Normalize(&v, cit->second.second);
+      for (CompMap::iterator nit = v.begin(); nit != v.end(); ++nit) {
+        sum.mass[nit->first] += nit->second;
+      }
+    }
+
+    if (prev != NULL) {
+      RecordedInventory& p = (*prev)[it->first];
+      std::set<int> nucs;
+      for (CompMap::iterator nit = sum.mass.begin(); nit != sum.mass.end();
+           ++nit) {
+        nucs.insert(nit->first);
+      }
+      for (std::set<int>::iterator nit = p.nucs.begin(); nit != p.nucs.end();
+           ++nit) {
+        if (nucs.count(*nit) == 0) {
+          sum.mass[*nit] = 0;
+        }
+      }
+      p.nucs.swap(nucs);
+      p.units = sum.units;
     }
+    sums->push_back(sum);
+  }
+
+  if (prev == NULL) {
+    return;
+  }
 
-    Material::Ptr m = ResCast<Material>(mats[0]->Clone());
-    for (int i = 1; i < mats.size(); i++) {
-      m->Absorb(ResCast<Material>(mats[i]->Clone()));
+  // inventories recorded before that are now empty or gone
+  std::map<std::string, RecordedInventory>::iterator pit = prev->begin();
+  while (pit != prev->end()) {
+    if (held.count(pit->first) > 0) {
+      ++pit;
+      continue;
     }
-    RecordInventory(a, name, m);
+    InventorySum sum;
+    sum.name = pit->first;
+    sum.units = pit->second.units;
+    sum.qty = 0;
+    std::set<int>& nucs = pit->second.nucs;
+    for (std::set<int>::iterator nit = nucs.begin(); nit != nucs.end();
+         ++nit) {
+      sum.mass[*nit] = 0;
+    }
+    sums->push_back(sum);
+    prev->erase(pit++);
   }
 }
 
-void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
+void Timer::RecordInventory(Agent* a, const InventorySum& inv) {
   if (si_.explicit_inventory) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, m->quantity());
-    CompMap::iterator it;
-    for (it = c.begin(); it != c.end(); ++it) {
+    CompMap::const_iterator it;
+    for (it = inv.mass.begin(); it != inv.mass.end(); ++it) {
       ctx_->NewDatum("ExplicitInventory")
           ->AddVal("AgentId", a->id())
           ->AddVal("Time", time_)
-          ->AddVal("InventoryName", name)
+          ->AddVal("InventoryName", inv.name)
           ->AddVal("NucId", it->first)
           ->AddVal("Quantity", it->second)
-          ->AddVal("Units", m->units())
+          ->AddVal("Units", inv.units)
           ->Record();
     }
   }
 
   if (si_.explicit_inventory_compact) {
-    CompMap c = m->comp()->mass();
+    // nuclides with a zero mass only mark that they were removed
+    CompMap c;
+    CompMap::const_iterator it;
+    for (it = inv.mass.begin(); it != inv.mass.end(); ++it) {
+      if (it->second > 0) {
+        c[it->first] = it->second;
+      }
+    }
     compmath::Normalize(&c, 1);
     ctx_->NewDatum("ExplicitInventoryCompact")
         ->AddVal("AgentId", a->id())
         ->AddVal("Time", time_)
-        ->AddVal("InventoryName", name)
-        ->AddVal("Quantity", m->quantity())
-        ->AddVal("Units", m->units())
+        ->AddVal("InventoryName", inv.name)
+        ->AddVal("Quantity", inv.qty)
+        ->AddVal("Units", inv.units)
         ->AddVal("Composition", c)
         ->Record();
   }
@@ -199,17 +577,102 @@ void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
 
 void Timer::DoDecom() {
   // decommission queued agents
-  std::vector<Agent*> decom_list = decom_queue_[time_];
+  std::map<int, std::list<Agent*>>::iterator it = decom_queue_.find(time_);
+  if (it == decom_queue_.end()) {
+    return;
+  }
+  std::vector<Agent*> decom_list(it->second.begin(), it->second.end());
   for (int i = 0; i < decom_list.size(); ++i) {
     Agent* m = decom_list[i];
+    // skip agents rescheduled while decommissioning an earlier one
+    std::map<Agent*, std::pair<int, std::list<Agent*>::iterator>>::iterator
+        idx = decom_index_.find(m);
+    if (idx == decom_index_.end() || idx->second.first != time_) {
+      continue;
+    }
+    RemoveDecom(m);
+
     if (m->parent() != NULL) {
+      Wake(m->parent()->id());
       m->parent()->DecomNotify(m);
     }
     m->Decommission();
   }
 }
 
+void Timer::WakeDue() {
+  while (!wake_queue_.empty() && wake_queue_.begin()->first <= time_) {
+    std::set<int>& ids = wake_queue_.begin()->second;
+    for (std::set<int>::iterator it = ids.begin(); it != ids.end(); ++it) {
+      sleepers_.erase(*it);
+    }
+    wake_queue_.erase(wake_queue_.begin());
+    awake_dirty_ = true;
+  }
+}
+
+void Timer::UpdateAwake() {
+  if (!awake_dirty_) {
+    return;
+  }
+
+  awake_cpp_.clear();
+  awake_py_.clear();
+  for (int i = 0; i < cpp_tickers_.size(); ++i) {
+    if (sleepers_.count(cpp_tickers_[i]->id()) == 0) {
+      awake_cpp_.push_back(cpp_tickers_[i]);
+    }
+  }
+  for (int i = 0; i < py_tickers_.size(); ++i) {
+    if (sleepers_.count(py_tickers_[i]->id()) == 0) {
+      awake_py_.push_back(py_tickers_[i]);
+    }
+  }
+  awake_dirty_ = false;
+}
+
+bool Timer::RemoveSleeper(int agent_id) {
+  std::map<int, int>::iterator it = sleepers_.find(agent_id);
+  if (it == sleepers_.end()) {
+    return false;
+  }
+
+  std::set<int>& ids = wake_queue_[it->second];
+  ids.erase(agent_id);
+  if (ids.empty()) {
+    wake_queue_.erase(it->second);
+  }
+  sleepers_.erase(it);
+  awake_dirty_ = true;
+  return true;
+}
+
+void Timer::SleepUntil(int agent_id, int t) {
+#pragma omp critical(timer_sleep)
+  {
+    RemoveSleeper(agent_id);
+    if (t > time_) {
+      sleepers_[agent_id] = t;
+      wake_queue_[t].insert(agent_id);
+      awake_dirty_ = true;
+    }
+  }
+}
+
+void Timer::Wake(int agent_id) {
+#pragma omp critical(timer_sleep)
+  RemoveSleeper(agent_id);
+}
+
+bool Timer::IsAsleep(int agent_id) {
+  bool asleep;
+#pragma omp critical(timer_sleep)
+  asleep = !sleepers_.empty() && sleepers_.count(agent_id) > 0;
+  return asleep;
+}
+
 void Timer::RegisterTimeListener(TimeListener* agent) {
+  awake_dirty_ = true;
   tickers_[agent->id()] = agent;
   if (agent->IsShim()) {
     py_tickers_.push_back(agent);
@@ -219,6 +682,8 @@ void Timer::RegisterTimeListener(TimeListener* agent) {
 }
 
 void Timer::UnregisterTimeListener(TimeListener* tl) {
+  Wake(tl->id());
+  awake_dirty_ = true;
   tickers_.erase(tl->id());
   if (tl->IsShim()) {
     py_tickers_.erase(std::remove(py_tickers_.begin(), py_tickers_.end(), tl),
@@ -227,6 +692,8 @@ void Timer::UnregisterTimeListener(TimeListener* tl) {
     cpp_tickers_.erase(
         std::remove(cpp_tickers_.begin(), cpp_tickers_.end(), tl),
         cpp_tickers_.end());
+    tick_sched_.Forget(tl);
+    tock_sched_.Forget(tl);
   }
 }
 
@@ -237,6 +704,34 @@ void Timer::SchedBuild(Agent* parent, std::string proto_name, int t) {
   build_queue_[t].push_back(std::make_pair(proto_name, parent));
 }
 
+bool Timer::DeferBuild(Agent* parent, std::string proto_name, int t) {
+  if (!deferring_) {
+    return false;
+  }
+#if CYCLUS_IS_PARALLEL
+  int tid = omp_get_thread_num();
+#else
+  int tid = 0;
+#endif  // CYCLUS_IS_PARALLEL
+  DeferredSched d = {deciding_[tid], true, parent, proto_name, t};
+  deferred_[tid].push_back(d);
+  return true;
+}
+
+bool Timer::DeferDecom(Agent* m, int t) {
+  if (!deferring_) {
+    return false;
+  }
+#if CYCLUS_IS_PARALLEL
+  int tid = omp_get_thread_num();
+#else
+  int tid = 0;
+#endif  // CYCLUS_IS_PARALLEL
+  DeferredSched d = {deciding_[tid], false, m, "", t};
+  deferred_[tid].push_back(d);
+  return true;
+}
+
 void Timer::SchedDecom(Agent* m, int t) {
   if (t < time_) {
     throw ValueError("Cannot schedule decommission for t < [current-time]");
@@ -247,26 +742,30 @@ void Timer::SchedDecom(Agent* m, int t) {
   // - the duplicate entries will result in a double delete attempt and
   // segfaults and otherwise bad things.  Remove previous decommissionings
   // before scheduling this new one.
-  std::map<int, std::vector<Agent*>>::iterator it;
-  bool done = false;
-  for (it = decom_queue_.begin(); it != decom_queue_.end(); ++it) {
-    int t = it->first;
-    std::vector<Agent*> ags = it->second;
-    for (int i = 0; i < ags.size(); i++) {
-      if (ags[i] == m) {
-        CLOG(LEV_WARN) << "scheduled over previous decommissioning of "
-                       << m->id();
-        decom_queue_[t].erase(decom_queue_[t].begin() + i);
-        done = true;
-        break;
-      }
-    }
-    if (done) {
-      break;
-    }
+  if (RemoveDecom(m)) {
+    CLOG(LEV_WARN) << "scheduled over previous decommissioning of "
+                   << m->id();
   }
 
-  decom_queue_[t].push_back(m);
+  std::list<Agent*>& agents = decom_queue_[t];
+  decom_index_[m] = std::make_pair(t, agents.insert(agents.end(), m));
+}
+
+bool Timer::RemoveDecom(Agent* m) {
+  std::map<Agent*, std::pair<int, std::list<Agent*>::iterator>>::iterator it =
+      decom_index_.find(m);
+  if (it == decom_index_.end()) {
+    return false;
+  }
+
+  std::map<int, std::list<Agent*>>::iterator q =
+      decom_queue_.find(it->second.first);
+  q->second.erase(it->second.second);
+  if (q->second.empty()) {
+    decom_queue_.erase(q);
+  }
+  decom_index_.erase(it);
+  return true;
 }
 
 int Timer::time() {
@@ -279,7 +778,18 @@ void Timer::Reset() {
   py_tickers_.clear();
   build_queue_.clear();
   decom_queue_.clear();
+  decom_index_.clear();
+  recorded_invs_.clear();
   si_ = SimInfo(0);
+  snap_cache_.reset();
+  tick_sched_.Clear();
+  tock_sched_.Clear();
+  profiler_.reset();
+  sleepers_.clear();
+  wake_queue_.clear();
+  awake_cpp_.clear();
+  awake_py_.clear();
+  awake_dirty_ = true;
 
   progress_bar_.reset();
 }
@@ -290,6 +800,12 @@ void Timer::Initialize(Context* ctx, SimInfo si) {
   }
 
   want_kill_ = false;
+  snap_cache_.reset();
+  tick_sched_.policy(TickScheduler::EnvPolicy());
+  tock_sched_.policy(tick_sched_.policy());
+  parallel_builds_ = Env::GetEnv("CYCLUS_PARALLEL_BUILDS").size() > 0;
+  int interval = AgentProfiler::EnvInterval();
+  profiler_.reset(interval > 0 ? new AgentProfiler(ctx, interval) : NULL);
   ctx_ = ctx;
   time_ = 0;
   si_ = si;
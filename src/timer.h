@@ -1,15 +1,19 @@
 #ifndef CYCLUS_SRC_TIMER_H_
 #define CYCLUS_SRC_TIMER_H_
 
+#include <list>
+#include <set>
 #include <utility>
 #include <vector>
 #include <memory>
 
+#include "agent_profiler.h"
 #include "context.h"
 #include "exchange_manager.h"
 #include "product.h"
 #include "material.h"
 #include "infile_tree.h"
+#include "tick_scheduler.h"
 #include "time_listener.h"
 #include "comp_math.h"
 #include "indicators.hpp"
@@ -19,8 +23,20 @@ class SimInitTest;
 namespace cyclus {
 
 class Agent;
+class SnapshotCache;
 
 /// Controls simulation timestepping and inter-timestep phases.
+///
+/// The Tick and Tock of C++ agents are distributed over threads as set by the
+/// CYCLUS_TICK_SCHEDULE environment variable: "static" (the default) splits
+/// agents evenly, "cost" balances them by their measured run time (see
+/// TickScheduler).
+///
+/// If the CYCLUS_PARALLEL_BUILDS environment variable is set, the agents
+/// queued to be built in a timestep are cloned from their prototypes in
+/// parallel before they are built one at a time (see Context::CreateAgents).
+/// Any agents made by the Build or BuildNotify of a batch are then given ids
+/// after the whole batch rather than in between its members.
 class Timer {
   friend class ::SimInitTest;
 
@@ -51,6 +67,17 @@ class Timer {
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Puts the agent with the given id to sleep until the start of timestep t,
+  /// see Context::SleepUntil. This may be called concurrently.
+  void SleepUntil(int agent_id, int t);
+
+  /// Wakes the agent with the given id. This may be called concurrently.
+  void Wake(int agent_id);
+
+  /// Returns whether the agent with the given id is asleep. This may be called
+  /// concurrently.
+  bool IsAsleep(int agent_id);
+
   /// Schedules the named prototype to be built for the specified parent at
   /// timestep t.
   void SchedBuild(Agent* parent, std::string proto_name, int t);
@@ -59,6 +86,15 @@ class Timer {
   /// timestep t.
   void SchedDecom(Agent* m, int time);
 
+  /// Defers a build scheduled through Context::SchedBuild while decisions run
+  /// concurrently, until all of them are done. Returns false if the build is
+  /// not deferred and must be scheduled right away.
+  bool DeferBuild(Agent* parent, std::string proto_name, int t);
+
+  /// Defers a decommissioning scheduled through Context::SchedDecom while
+  /// decisions run concurrently, see DeferBuild.
+  bool DeferDecom(Agent* m, int t);
+
   /// Schedules a snapshot of simulation state to output database to occur at
   /// the beginning of the next timestep.
   void Snapshot() { want_snapshot_ = true; }
@@ -66,6 +102,10 @@ class Timer {
   /// Schedules the simulation to be terminated at the end of this timestep.
   void KillSim() { want_kill_ = true; }
 
+  /// Returns the profiler that agent phase times are added to, or NULL if
+  /// profiling is disabled (see CYCLUS_PROFILE in AgentProfiler).
+  AgentProfiler* profiler() { return profiler_.get(); }
+
   /// Returns the current time, in months since the simulation started.
   ///
   /// @return the current time
@@ -86,7 +126,28 @@ class Timer {
   int CalcTimeDiff(int year, int month);
 
  private:
-  /// builds all agents queued for the current timestep.
+  /// Returns whether a snapshot is to be taken at the start of the current
+  /// timestep.
+  bool SnapshotDue();
+
+  /// Returns whether the explicit inventory tables are to be recorded in the
+  /// current timestep.
+  bool InventoryDue();
+
+  /// Returns whether nothing happens in the current timestep, i.e. all agents
+  /// are asleep and no build, decommission, snapshot or explicit inventory
+  /// recording is due.
+  bool Idle();
+
+  /// Advances time to the next timestep at which an agent wakes, a build,
+  /// decommission, periodic snapshot or explicit inventory recording is
+  /// scheduled or the simulation ends, and records the skipped timesteps in
+  /// the SkippedSteps table. The skipped timesteps still end profiling
+  /// windows, and Python events are polled once.
+  void SkipIdleSteps();
+
+  /// builds all agents queued for the current timestep, in the order they
+  /// were scheduled.
   void DoBuild();
 
   /// sends the tick signal to all of the agents receiving time
@@ -102,15 +163,91 @@ class Timer {
   void DoTock();
 
   /// sends the decision signal to all agents recieving time
-  /// notifications.
+  /// notifications. Listeners with a ParallelDecision decide concurrently
+  /// first, and all others in id order afterwards.
   void DoDecision();
 
-  void RecordInventories(Agent* a);
-  void RecordInventory(Agent* a, std::string name, Material::Ptr m);
+  /// A build or decommissioning scheduled during a concurrent decision.
+  struct DeferredSched {
+    /// the position of the deciding listener in the phase
+    int pos;
+    bool build;
+    Agent* agent;
+    std::string proto_name;
+    int t;
+  };
+
+  /// Schedules the builds and decommissionings deferred by the listeners
+  /// that decided concurrently, in listener order and then in the order each
+  /// listener scheduled them.
+  void SchedDeferred();
+
+  /// Records a snapshot of the simulation state, which is incremental if the
+  /// simulation is configured so.
+  void DoSnapshot();
+
+  /// The summed contents of one material inventory of an agent.
+  struct InventorySum {
+    std::string name;
+    std::string units;
+    double qty;
+    /// mass of each nuclide
+    CompMap mass;
+  };
+
+  /// Identifies the state of one material in an inventory. Untracked
+  /// materials keep their state id when they change, so the composition and
+  /// quantity are compared as well.
+  struct InventoryItem {
+    int state_id;
+    int comp_id;
+    double qty;
+    bool operator==(const InventoryItem& other) const {
+      return state_id == other.state_id && comp_id == other.comp_id &&
+             qty == other.qty;
+    }
+  };
+  typedef std::vector<InventoryItem> InventoryItems;
+
+  /// An inventory as it was last recorded.
+  struct RecordedInventory {
+    InventoryItems items;
+    std::string units;
+    /// the nuclides with a recorded mass
+    std::set<int> nucs;
+  };
+
+  /// Records the explicit inventory tables of all built agents if they are
+  /// due this timestep.
+  void RecordInventories();
+
+  /// Sums the material inventories of an agent. If prev is not NULL,
+  /// inventories whose materials did not change since they were last summed
+  /// are skipped and prev is updated. Nuclides that are no longer in an
+  /// inventory are then summed with a zero mass, and an inventory that was
+  /// emptied or removed is summed once with a zero quantity.
+  void SumInventories(Agent* a,
+                      std::map<std::string, RecordedInventory>* prev,
+                      std::vector<InventorySum>* sums);
+  void RecordInventory(Agent* a, const InventorySum& inv);
 
   /// decommissions all agents queued for the current timestep.
   void DoDecom();
 
+  /// wakes all agents whose sleep ends at or before the current timestep.
+  void WakeDue();
+
+  /// Removes an agent from the sleeping agents, returns whether it was
+  /// asleep.
+  bool RemoveSleeper(int agent_id);
+
+  /// Removes an agent from decom_queue_, returns whether it was queued.
+  bool RemoveDecom(Agent* m);
+
+  /// Updates awake_cpp_ and awake_py_ if agents fell asleep, woke or were
+  /// (un)registered since they were last updated.
+  void UpdateAwake();
+
   /// @brief Determines whether or not to print the progress bar
   /// @return false if CYCLUS_PROGRESS_BAR is set to 0, false, no, or off;
   /// otherwise false when log verbosity is greater than LEV_WARN.
@@ -149,6 +286,9 @@ class Timer {
   bool want_snapshot_ = false;
   bool want_kill_ = false;
 
+  /// Agent state of the previous incremental snapshot
+  std::shared_ptr<SnapshotCache> snap_cache_;
+
   /// Concrete agents that desire to receive tick and tock notifications
   std::map<int, TimeListener*> tickers_;
   /// The union of these two vectors should produce tickers_.
@@ -156,11 +296,47 @@ class Timer {
   std::vector<TimeListener*> cpp_tickers_;
   std::vector<TimeListener*> py_tickers_;
 
+  /// Distribute the Tick and Tock of cpp_tickers_ over threads, see
+  /// CYCLUS_TICK_SCHEDULE.
+  TickScheduler tick_sched_;
+  TickScheduler tock_sched_;
+
+  // std::map<AgentId, wake time> of sleeping agents
+  std::map<int, int> sleepers_;
+  // std::map<wake time, std::set<AgentId> >
+  std::map<int, std::set<int>> wake_queue_;
+
+  /// The listeners in cpp_tickers_ and py_tickers_ that are not asleep.
+  std::vector<TimeListener*> awake_cpp_;
+  std::vector<TimeListener*> awake_py_;
+  bool awake_dirty_ = true;
+
+  std::unique_ptr<AgentProfiler> profiler_;
+
+  /// Whether decisions run concurrently, and the builds and
+  /// decommissionings they schedule are deferred.
+  bool deferring_ = false;
+  /// The position of the listener each thread is running, and the
+  /// schedulings deferred by each thread.
+  std::vector<int> deciding_;
+  std::vector<std::vector<DeferredSched>> deferred_;
+
+  // std::map<AgentId, std::map<inventory name, materials> > of the
+  // inventories last recorded if explicit_inventory_incremental is set
+  std::map<int, std::map<std::string, RecordedInventory>> recorded_invs_;
+
   // std::map<time,std::vector<std::pair<prototype, parent> > >
   std::map<int, std::vector<std::pair<std::string, Agent*>>> build_queue_;
 
-  // std::map<time,std::vector<config> >
-  std::map<int, std::vector<Agent*>> decom_queue_;
+  // std::map<time,std::list<agent> >
+  std::map<int, std::list<Agent*>> decom_queue_;
+
+  /// The time each agent in decom_queue_ is decommissioned at and its
+  /// position in that time's list, so that it can be rescheduled without
+  /// searching the queue.
+  std::map<Agent*, std::pair<int, std::list<Agent*>::iterator>> decom_index_;
+
+  bool parallel_builds_ = false;
 
   /// Progress bar for simulation progress
   std::unique_ptr<indicators::ProgressBar> progress_bar_ = nullptr;
@@ -260,6 +260,8 @@ void MatlBuyPolicy::Start() {
     throw ValueError(ss.str());
   }
   manager()->context()->RegisterTrader(this);
+  // buy policies never bid
+  manager()->context()->SupplyCommods(this, std::set<std::string>());
 }
 
 void MatlBuyPolicy::Stop() {
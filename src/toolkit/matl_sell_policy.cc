@@ -144,6 +144,9 @@ MatlSellPolicy& MatlSellPolicy::Init(Agent* manager, ResBuf<Material>* buf,
 
 MatlSellPolicy& MatlSellPolicy::Set(std::string commod) {
   commods_.insert(commod);
+  if (manager() != NULL && manager()->context()->traders().count(this) > 0) {
+    manager()->context()->SupplyCommods(this, commods_);
+  }
   return *this;
 }
 
@@ -154,6 +157,8 @@ void MatlSellPolicy::Start() {
     throw ValueError(ss.str());
   }
   manager()->context()->RegisterTrader(this);
+  // only ask for bids when the commodities are requested
+  manager()->context()->SupplyCommods(this, commods_);
 }
 
 void MatlSellPolicy::Stop() {
@@ -189,7 +194,7 @@ std::set<BidPortfolio<Material>::Ptr> MatlSellPolicy::GetMatlBids(
   bool excl = Excl();
   std::string commod;
   Request<Material>* req;
-  Material::Ptr m, offer;
+  Material::Ptr m;
   double qty;
   int n_full_bids = 0;
   double bid_qty;
@@ -197,6 +202,11 @@ std::set<BidPortfolio<Material>::Ptr> MatlSellPolicy::GetMatlBids(
   std::vector<double> bids;
   std::set<std::string>::iterator sit;
   std::vector<Request<Material>*>::const_iterator rit;
+
+  // Peek at resbuf to get current composition
+  m = buf_->Peek();
+  Material::Ptr buf_comp = Material::CreateUntracked(0, m->comp());
+
   for (sit = commods_.begin(); sit != commods_.end(); ++sit) {
     commod = *sit;
     if (commod_requests.count(commod) < 1) continue;
@@ -222,15 +232,13 @@ std::set<BidPortfolio<Material>::Ptr> MatlSellPolicy::GetMatlBids(
         bids.erase(bids.begin() + shippable_pkgs, bids.end());
       }
 
-      // Peek at resbuf to get current composition
-      m = buf_->Peek();
+      // offers are only created for bids that are traded, so all bids share
+      // either the request's target or a snapshot of the buffer composition
+      Material::Ptr like = ignore_comp_ ? req->target() : buf_comp;
 
       std::vector<double>::iterator bit;
       for (bit = bids.begin(); bit != bids.end(); ++bit) {
-        offer = ignore_comp_
-                    ? Material::CreateUntracked(*bit, req->target()->comp())
-                    : Material::CreateUntracked(*bit, m->comp());
-        port->AddBid(req, offer, this, excl);
+        port->AddBid(req, OfferSpec<Material>(*bit, like), this, excl);
         LG(INFO3) << "  - bid " << *bit << " kg on a request for " << commod;
       }
     }
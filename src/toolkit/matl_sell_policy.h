@@ -98,7 +98,8 @@ class MatlSellPolicy : public Trader {
   /// Registers this policy as a trader in the current simulation.  This
   /// function must be called for the policy to begin participating in resource
   /// exchange. Init MUST be called prior to calling this function.  Start is
-  /// idempotent.
+  /// idempotent. The policy is only asked for bids in exchanges with requests
+  /// for its commodities.
   void Start();
 
   /// Unregisters this policy as a trader in the current simulation. This
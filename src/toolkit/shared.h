@@ -0,0 +1,78 @@
+#ifndef CYCLUS_SRC_TOOLKIT_SHARED_H_
+#define CYCLUS_SRC_TOOLKIT_SHARED_H_
+
+#include <boost/shared_ptr.hpp>
+
+namespace cyclus {
+namespace toolkit {
+
+/// Shared is a copy-on-write handle to a value. Copying a handle only copies a
+/// pointer, so handles copied from one another share a single value until one
+/// of them modifies it through mut(), which first gives that handle its own
+/// copy if the value is shared.
+///
+/// State variables annotated with "shared": True are declared as Shared
+/// handles by cycpp. Since the generated Clone copies every state variable
+/// from the prototype, all agents of a prototype then share one copy of large
+/// parameters such as recipe lists and lookup tables instead of holding one
+/// each.
+///
+/// @code
+/// class MyAgent : public cyclus::Facility {
+///   public:
+///     void Tick() {
+///       double x = table->at("x");
+///       table.mut()["y"] = x;  // copies the table if it is shared
+///     }
+///
+///     #pragma cyclus var {"shared": True}
+///     std::map<std::string, double> table;
+/// };
+/// @endcode
+template <class T> class Shared {
+ public:
+  /// Creates a handle to a default constructed value. Default values are not
+  /// allocated until they are modified.
+  Shared() {}
+
+  Shared(const T& val) : val_(new T(val)) {}
+
+  /// Replaces the value of this handle without modifying the value of handles
+  /// it was shared with.
+  Shared& operator=(const T& val) {
+    val_.reset(new T(val));
+    return *this;
+  }
+
+  const T& get() const { return val_ ? *val_ : Default(); }
+  const T& operator*() const { return get(); }
+  const T* operator->() const { return &get(); }
+  operator const T&() const { return get(); }
+
+  /// Returns the value of this handle for modification, after copying it if
+  /// it is shared with any other handle.
+  T& mut() {
+    if (!val_) {
+      val_.reset(new T());
+    } else if (!val_.unique()) {
+      val_.reset(new T(*val_));
+    }
+    return *val_;
+  }
+
+  /// Returns true if this handle does not share its value with other handles.
+  bool unique() const { return !val_ || val_.unique(); }
+
+ private:
+  static const T& Default() {
+    static const T val = T();
+    return val;
+  }
+
+  boost::shared_ptr<T> val_;
+};
+
+}  // namespace toolkit
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_TOOLKIT_SHARED_H_
@@ -57,14 +57,21 @@ void RecordTimeSeries(std::string tsname, cyclus::Agent* agent, T value,
       ->AddVal("Value", value)
       ->AddVal("Units", units)
       ->Record();
-  std::vector<time_series_listener_t> vec = TIME_SERIES_LISTENERS[tsname];
-  for (auto f = vec.begin(); f != vec.end(); ++f) {
-    std::function<void(cyclus::Agent*, int, T, std::string)> fn =
-        boost::get<std::function<void(cyclus::Agent*, int, T, std::string)>>(
-            *f);
-    fn(agent, time, value, tsname);
+  auto it = TIME_SERIES_LISTENERS.find(tsname);
+  if (it != TIME_SERIES_LISTENERS.end()) {
+    const std::vector<time_series_listener_t>& vec = it->second;
+    for (auto f = vec.begin(); f != vec.end(); ++f) {
+      std::function<void(cyclus::Agent*, int, T, std::string)> fn =
+          boost::get<std::function<void(cyclus::Agent*, int, T, std::string)>>(
+              *f);
+      fn(agent, time, value, tsname);
+    }
+  }
+  // Python listeners are called in one batch per series at the end of the
+  // time step
+  if (PyHasTimeSeriesListeners(tsname)) {
+    PyBufferListeners(tsname, agent, agent->context(), time, value);
   }
-  PyCallListeners(tsname, agent, agent->context(), time, value);
 }
 
 }  // namespace toolkit
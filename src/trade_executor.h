@@ -1,12 +1,14 @@
 #ifndef CYCLUS_SRC_TRADE_EXECUTOR_H_
 #define CYCLUS_SRC_TRADE_EXECUTOR_H_
 
+#include <exception>
 #include <map>
 #include <set>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "agent_profiler.h"
 #include "context.h"
 #include "exchange_context.h"
 #include "trade.h"
@@ -45,10 +47,17 @@ template <class T> struct TradeExecutionContext {
 ///     #. Collecting responses for the group of trades from each supplier
 ///     #. Grouping all responses by requester (receiver)
 ///     #. Sending all grouped responses to their respective requester
+///
+/// If constructed with parallel set, suppliers that opt in with
+/// Trader::ParallelTrades are asked for their responses concurrently, as are
+/// such requesters to accept them. All other traders are then called one at a
+/// time. Responses are merged and recorded in the same order as in serial
+/// execution.
 template <class T> class TradeExecutor {
  public:
-  explicit TradeExecutor(const std::vector<Trade<T>>& trades)
-      : trades_(trades) {}
+  explicit TradeExecutor(const std::vector<Trade<T>>& trades,
+                         bool parallel = false)
+      : trades_(trades), parallel_(parallel) {}
 
   /// @brief execute all trades, collecting responders from bidders and sending
   /// responses to requesters
@@ -67,12 +76,13 @@ template <class T> class TradeExecutor {
   /// @brief execute all trades with access to exchange context for adjusted
   /// preferences
   void ExecuteTrades(Context* ctx, ExchangeContext<T>* ex_ctx) {
+    AgentProfiler* prof = ctx ? ctx->profiler() : NULL;
     GroupTradesBySupplier(trade_ctx_, trades_);
-    GetTradeResponses(trade_ctx_);
+    GetTradeResponses(trade_ctx_, parallel_, prof);
     if (ctx) {
       RecordTrades(ctx, ex_ctx);
     }
-    SendTradeResources(trade_ctx_);
+    SendTradeResources(trade_ctx_, parallel_, prof);
   }
 
   /// @brief Record all trades with the appropriate backends
@@ -128,19 +138,10 @@ template <class T> class TradeExecutor {
 
           // If we have access to the exchange context, use the adjusted
           // preference that was actually used by the solver
-          if (ex_ctx) {
-            auto trader_it = ex_ctx->trader_prefs.find(trade.request->requester());
-            if (trader_it != ex_ctx->trader_prefs.end()) {
-              auto request_it = trader_it->second.find(trade.request);
-              if (request_it != trader_it->second.end()) {
-                auto bid_it = request_it->second.find(trade.bid);
-                if (bid_it != request_it->second.end()) {
-                  adjusted_preference = bid_it->second;
-                }
-              }
-            }
-            // If any of the keys are not found, adjusted_preference remains
-            // the original preference
+          // If the bid is not part of the exchange context,
+          // adjusted_preference remains the original preference
+          if (ex_ctx && ex_ctx->HasBid(trade.bid)) {
+            adjusted_preference = ex_ctx->prefs[trade.bid->id()];
           }
 
           ctx->NewDatum("Transactions")
@@ -165,6 +166,7 @@ template <class T> class TradeExecutor {
 
  private:
   const std::vector<Trade<T>>& trades_;
+  bool parallel_;
   TradeExecutionContext<T> trade_ctx_;
 };
 
@@ -180,22 +182,77 @@ void GroupTradesBySupplier(TradeExecutionContext<T>& trade_ctx,
   }
 }
 
+/// @brief calls f(i) for each of n traders, first concurrently for those
+/// marked in concurrent and then one at a time, in order, for the rest
+template <class F>
+static void CallTraders(int n, const std::vector<bool>& concurrent, F f) {
+  std::vector<int> par;
+  for (int i = 0; i < n; ++i) {
+    if (concurrent[i]) {
+      par.push_back(i);
+    }
+  }
+
+  int m = par.size();
+  std::vector<std::exception_ptr> errors(m);
+#pragma omp parallel for schedule(dynamic)
+  for (int k = 0; k < m; ++k) {
+    try {
+      f(par[k]);
+    } catch (...) {
+      errors[k] = std::current_exception();
+    }
+  }
+  for (int k = 0; k < m; ++k) {
+    if (errors[k]) {
+      std::rethrow_exception(errors[k]);
+    }
+  }
+
+  for (int i = 0; i < n; ++i) {
+    if (!concurrent[i]) {
+      f(i);
+    }
+  }
+}
+
 /// @brief queries each supplier for the responses to thier matched trade and
 /// populates trades_by_requester_ and all_trades_ with the results
+///
+/// @param parallel if true, suppliers that allow it are queried concurrently
+/// @param prof if not NULL, the time each supplier takes is added to it
 template <class T>
-static void GetTradeResponses(TradeExecutionContext<T>& trade_ctx) {
-  std::set<Trader*>::iterator it;
-  for (it = trade_ctx.suppliers.begin(); it != trade_ctx.suppliers.end();
-       ++it) {
-    // get responses
-    Trader* supplier = *it;
-    std::vector<std::pair<Trade<T>, typename T::Ptr>> responses;
-    PopulateTradeResponses(supplier, trade_ctx.trades_by_supplier[supplier],
-                           responses);
-
-    // populate containers
+static void GetTradeResponses(TradeExecutionContext<T>& trade_ctx,
+                              bool parallel = false,
+                              AgentProfiler* prof = NULL) {
+  std::vector<Trader*> suppliers(trade_ctx.suppliers.begin(),
+                                 trade_ctx.suppliers.end());
+  int n = suppliers.size();
+  std::vector<bool> concurrent(n, false);
+  std::vector<const std::vector<Trade<T>>*> trades(n);
+  for (int i = 0; i < n; ++i) {
+    concurrent[i] = parallel && suppliers[i]->ParallelTrades();
+    trades[i] = &trade_ctx.trades_by_supplier[suppliers[i]];
+  }
+
+  // each supplier fills its own slot, so no locking is needed here
+  std::vector<std::vector<std::pair<Trade<T>, typename T::Ptr>>> responses(n);
+  CallTraders(n, concurrent, [&](int i) {
+    if (prof == NULL) {
+      PopulateTradeResponses(suppliers[i], *trades[i], responses[i]);
+    } else {
+      double start = AgentProfiler::Now();
+      PopulateTradeResponses(suppliers[i], *trades[i], responses[i]);
+      prof->Add(suppliers[i]->manager(), ExchangePhases<T>::kTrades,
+                AgentProfiler::Now() - start);
+    }
+  });
+
+  // populate containers
+  for (int i = 0; i < n; ++i) {
+    Trader* supplier = suppliers[i];
     typename std::vector<std::pair<Trade<T>, typename T::Ptr>>::iterator r_it;
-    for (r_it = responses.begin(); r_it != responses.end(); ++r_it) {
+    for (r_it = responses[i].begin(); r_it != responses[i].end(); ++r_it) {
       // @todo unsure if this is needed...
       // Trade<T>& trade = r_it->first;
       // typename T::Ptr rsrc= r_it->second;
@@ -210,14 +267,36 @@ static void GetTradeResponses(TradeExecutionContext<T>& trade_ctx) {
   }
 }
 
+/// @brief sends each requester the responses to its matched trades
+///
+/// @param parallel if true, requesters that allow it accept their trades
+/// concurrently
+/// @param prof if not NULL, the time each requester takes is added to it
 template <class T>
-static void SendTradeResources(TradeExecutionContext<T>& trade_ctx) {
-  std::set<Trader*>::iterator it;
-  for (it = trade_ctx.requesters.begin(); it != trade_ctx.requesters.end();
-       ++it) {
-    Trader* requester = *it;
-    AcceptTrades(requester, trade_ctx.trades_by_requester[requester]);
+static void SendTradeResources(TradeExecutionContext<T>& trade_ctx,
+                               bool parallel = false,
+                               AgentProfiler* prof = NULL) {
+  std::vector<Trader*> requesters(trade_ctx.requesters.begin(),
+                                  trade_ctx.requesters.end());
+  int n = requesters.size();
+  std::vector<bool> concurrent(n, false);
+  std::vector<const std::vector<std::pair<Trade<T>, typename T::Ptr>>*>
+      responses(n);
+  for (int i = 0; i < n; ++i) {
+    concurrent[i] = parallel && requesters[i]->ParallelTrades();
+    responses[i] = &trade_ctx.trades_by_requester[requesters[i]];
   }
+
+  CallTraders(n, concurrent, [&](int i) {
+    if (prof == NULL) {
+      AcceptTrades(requesters[i], *responses[i]);
+    } else {
+      double start = AgentProfiler::Now();
+      AcceptTrades(requesters[i], *responses[i]);
+      prof->Add(requesters[i]->manager(), ExchangePhases<T>::kAccept,
+                AgentProfiler::Now() - start);
+    }
+  });
 }
 
 }  // namespace cyclus
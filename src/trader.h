@@ -27,6 +27,14 @@ class Trader {
 
   virtual Agent* manager() { return manager_; }
 
+  /// Returns true if this trader's GetMatlTrades/GetProductTrades and
+  /// AcceptMatlTrades/AcceptProductTrades may run concurrently with those of
+  /// other traders when trades are executed in parallel (see
+  /// CYCLUS_PARALLEL_TRADES). They must then only modify this trader's own
+  /// state and the resources being traded. Traders that return false are
+  /// called one at a time afterwards.
+  virtual bool ParallelTrades() { return false; }
+
   /// @brief default implementation for material requests
   virtual std::set<RequestPortfolio<Material>::Ptr> GetMatlRequests() {
     return std::set<RequestPortfolio<Material>::Ptr>();
@@ -49,10 +57,34 @@ class Trader {
     return std::set<BidPortfolio<Product>::Ptr>();
   }
 
+  /// @brief default implementation for material preferences, which forwards
+  /// the preferences to the nested-map AdjustMatlPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustMatlPrefs(PrefMap<Material>& prefs) {
+    AdjustMatlPrefs(prefs.legacy());
+  }
+
+  /// @brief default implementation for product preferences, which forwards
+  /// the preferences to the nested-map AdjustProductPrefs overload. Agents
+  /// should override this version rather than the nested-map version to avoid
+  /// the cost of building the map.
+  virtual void AdjustProductPrefs(PrefMap<Product>& prefs) {
+    AdjustProductPrefs(prefs.legacy());
+  }
+
   /// default implementation for material preferences.
+  /// @deprecated override AdjustMatlPrefs(PrefMap<Material>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Trader::AdjustMatlPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {}
 
-  /// default implementation for material preferences.
+  /// default implementation for product preferences.
+  /// @deprecated override AdjustProductPrefs(PrefMap<Product>&) instead
+  /// Subclasses that still override this version should add
+  /// `using cyclus::Trader::AdjustProductPrefs;`
+  /// so that the other overload is not hidden.
   virtual void AdjustProductPrefs(PrefMap<Product>::type& prefs) {}
 
   /// @brief default implementation for responding to material trades
@@ -6,7 +6,11 @@
 #include <set>
 #include <streambuf>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
 #include <libxml++/libxml++.h>
 
 #include "agent.h"
@@ -97,16 +101,109 @@ std::vector<AgentSpec> ParseSpecs(std::string infile, std::string format) {
   return specs;
 }
 
+/// Returns the path that the master schema built from the template master
+/// for specs is cached at, or an empty string if it cannot be cached. The
+/// cache is keyed by the template, the specs and the size and modification
+/// time of each spec's module library, which changes whenever the agent's
+/// schema or version can. The full key is set to key and stored in the cached
+/// file, since the path only holds its hash. Python modules are never cached
+/// because their source may change without their path changing.
+static std::string MasterSchemaCachePath(const std::string& master,
+                                         std::vector<AgentSpec>& specs,
+                                         std::string* key) {
+  std::string dir = Env::schema_cache();
+  if (dir.empty())
+    return "";
+
+  std::stringstream full;
+  full << master.size() << "\n" << master;
+  for (int i = 0; i < specs.size(); ++i) {
+    std::string path;
+    try {
+      path = Env::FindModule(specs[i].LibPath(), specs[i].lib());
+    } catch (Error& e) {
+      return "";
+    }
+    if (boost::starts_with(path, "<py>"))
+      return "";
+
+    boost::system::error_code errc;
+    boost::uintmax_t size = fs::file_size(path, errc);
+    if (errc)
+      return "";
+    std::time_t mtime = fs::last_write_time(path, errc);
+    if (errc)
+      return "";
+    full << "\n" << specs[i].str() << "\n" << path << "\n" << size << "\n"
+         << mtime;
+  }
+  *key = full.str();
+
+  std::stringstream name;
+  name << "master-" << std::hex << boost::hash<std::string>()(*key) << ".rng";
+  return (fs::path(dir) / name.str()).string();
+}
+
+/// Reads the master schema cached at path into master. Returns false if there
+/// is no schema cached there for key, e.g. because another key has the same
+/// hash.
+static bool ReadCachedMasterSchema(const std::string& path,
+                                   const std::string& key,
+                                   std::string* master) {
+  if (!fs::exists(path))
+    return false;
+  std::stringstream ss;
+  LoadRawStringstreamFromFile(ss, path);
+  std::string cached = ss.str();
+
+  // the file holds the length of the key, the key and the schema
+  std::size_t pos = cached.find('\n');
+  std::stringstream len;
+  len << key.size();
+  if (pos == std::string::npos || cached.compare(0, pos, len.str()) != 0 ||
+      cached.compare(pos + 1, key.size(), key) != 0)
+    return false;
+  *master = cached.substr(pos + 1 + key.size());
+  return true;
+}
+
+/// Writes a master schema to the cache at path along with its key. The schema
+/// is written to a uniquely named file first and then renamed, so that
+/// simulations started concurrently never read a partially written schema.
+/// Failing to write the cache is not an error.
+static void CacheMasterSchema(const std::string& path, const std::string& key,
+                              const std::string& master) {
+  boost::system::error_code errc;
+  fs::create_directories(fs::path(path).parent_path(), errc);
+  std::string tmp = path + "." +
+                    boost::uuids::to_string(boost::uuids::random_generator()());
+  std::ofstream f(tmp.c_str());
+  f << key.size() << "\n" << key << master;
+  f.close();
+  if (!f.fail())
+    fs::rename(tmp, path, errc);
+  if (f.fail() || errc) {
+    CLOG(LEV_DEBUG1) << "Could not cache master schema at " << path;
+    fs::remove(tmp, errc);
+  }
+}
+
 std::string BuildMasterSchema(
     std::string schema_path, std::vector<AgentSpec> specs) {
-  Timer ti;
-  Recorder rec;
-  Context ctx(&ti, &rec);
-
   std::stringstream schema("");
   LoadStringstreamFromFile(schema, schema_path);
   std::string master = schema.str();
 
+  std::string key;
+  std::string cached;
+  std::string cache_path = MasterSchemaCachePath(master, specs, &key);
+  if (!cache_path.empty() && ReadCachedMasterSchema(cache_path, key, &cached))
+    return cached;
+
+  Timer ti;
+  Recorder rec;
+  Context ctx(&ti, &rec);
+
   std::map<std::string, std::string> subschemas;
 
   // force element types to exist so we always replace the config string
@@ -133,6 +230,8 @@ std::string BuildMasterSchema(
     }
   }
 
+  if (!cache_path.empty())
+    CacheMasterSchema(cache_path, key, master);
   return master;
 }
 
@@ -202,6 +301,7 @@ XMLFileLoader::XMLFileLoader(Recorder* r, QueryableBackend* b,
 }
 
 XMLFileLoader::~XMLFileLoader() {
+  rec_->UnregisterStagingBackend(&stage_);
   delete ctx_;
 }
 
@@ -212,7 +312,7 @@ std::string XMLFileLoader::master_schema() {
 void XMLFileLoader::LoadSim() {
   std::stringstream ss(master_schema());
   if (ms_print_) {
-    std::cout << master_schema() << std::endl;
+    std::cout << ss.str() << std::endl;
   }
   parser_->Validate(ss);
   LoadControlParams();  // must be first
@@ -412,26 +512,7 @@ void XMLFileLoader::LoadInitialAgents() {
       AgentSpec spec = specs_[alias];
 
       Agent* agent = DynamicModule::Make(ctx_, spec);
-
-      // call manually without agent impl injected to keep all Agent state in a
-      // single, consolidated db table
-      agent->Agent::InfileToDb(qe, DbInit(agent, true));
-
-      agent->InfileToDb(qe, DbInit(agent));
-      rec_->Flush();
-
-      std::vector<Cond> conds;
-      conds.push_back(Cond("SimId", "==", rec_->sim_id()));
-      conds.push_back(Cond("SimTime", "==", static_cast<int>(0)));
-      conds.push_back(Cond("AgentId", "==", agent->id()));
-      CondInjector ci(b_, conds);
-      PrefixInjector pi(&ci, "AgentState");
-
-      // call manually without agent impl injected
-      agent->Agent::InitFrom(&pi);
-
-      pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
-      agent->InitFrom(&pi);
+      InitPrototype(qe, agent, spec);
       ctx_->AddPrototype(prototype, agent);
     }
   }
@@ -463,6 +544,31 @@ void XMLFileLoader::LoadInitialAgents() {
   }
 }
 
+void XMLFileLoader::InitPrototype(InfileTree* qe, Agent* agent,
+                                  AgentSpec spec) {
+  rec_->RegisterStagingBackend(&stage_);
+
+  // call manually without agent impl injected to keep all Agent state in a
+  // single, consolidated db table
+  agent->Agent::InfileToDb(qe, DbInit(agent, true));
+
+  agent->InfileToDb(qe, DbInit(agent));
+  rec_->UnregisterStagingBackend(&stage_);
+
+  // the staging backend only holds the rows of this simulation's prototypes,
+  // all recorded at time zero
+  std::vector<Cond> conds;
+  conds.push_back(Cond("AgentId", "==", agent->id()));
+  CondInjector ci(&stage_, conds);
+  PrefixInjector pi(&ci, "AgentState");
+
+  // call manually without agent impl injected
+  agent->Agent::InitFrom(&pi);
+
+  pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
+  agent->InitFrom(&pi);
+}
+
 Agent* XMLFileLoader::BuildAgent(std::string proto, Agent* parent) {
   Agent* m = ctx_->CreateAgent<Agent>(proto);
   m->Build(parent);
@@ -499,6 +605,15 @@ void XMLFileLoader::LoadControlParams() {
   si.explicit_inventory = OptionalQuery<bool>(qe, "explicit_inventory", false);
   si.explicit_inventory_compact =
       OptionalQuery<bool>(qe, "explicit_inventory_compact", false);
+  si.explicit_inventory_interval =
+      OptionalQuery<int>(qe, "explicit_inventory_interval", 1);
+  si.explicit_inventory_incremental =
+      OptionalQuery<bool>(qe, "explicit_inventory_incremental", false);
+
+  // get periodic snapshot settings
+  si.snapshot_interval = OptionalQuery<int>(qe, "snapshot_interval", 0);
+  si.snapshot_incremental =
+      OptionalQuery<bool>(qe, "snapshot_incremental", false);
 
   // get time step duration
   si.dt = OptionalQuery<int>(qe, "dt", kDefaultTimeStepDur);
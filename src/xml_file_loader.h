@@ -9,6 +9,7 @@
 #include "composition.h"
 #include "dynamic_module.h"
 #include "infile_tree.h"
+#include "mem_back.h"
 #include "xml_parser.h"
 #include "timer.h"
 #include "recorder.h"
@@ -114,6 +115,11 @@ class XMLFileLoader {
   /// commodity
   void ProcessCommodities(std::map<std::string, double>* commodity_priority);
 
+  /// Initializes a prototype from its input file entry qe. Its state is
+  /// recorded as usual and read back by InitFrom from the staging backend, so
+  /// that the output database is not flushed and queried for each prototype.
+  void InitPrototype(InfileTree* qe, Agent* agent, AgentSpec spec);
+
   /// Creates and builds an agent, notifying its parent. The agent init info is
   /// translated and stored in the output db.
   Agent* BuildAgent(std::string proto, Agent* parent);
@@ -123,6 +129,9 @@ class XMLFileLoader {
   Context* ctx_;
   QueryableBackend* b_;
 
+  /// in-memory copy of the prototype state recorded by InitPrototype
+  MemBack stage_;
+
   /// flag to indicate printing master schema
   bool ms_print_;
 
@@ -70,26 +70,7 @@ void XMLFlatLoader::LoadInitialAgents() {
     AgentSpec spec = specs_[alias];
 
     Agent* agent = DynamicModule::Make(ctx_, spec);
-
-    // call manually without agent impl injected to keep all Agent state in a
-    // single, consolidated db table
-    agent->Agent::InfileToDb(qe, DbInit(agent, true));
-
-    agent->InfileToDb(qe, DbInit(agent));
-    rec_->Flush();
-
-    std::vector<Cond> conds;
-    conds.push_back(Cond("SimId", "==", rec_->sim_id()));
-    conds.push_back(Cond("AgentId", "==", agent->id()));
-    conds.push_back(Cond("SimTime", "==", static_cast<int>(0)));
-    CondInjector ci(b_, conds);
-    PrefixInjector pi(&ci, "AgentState");
-
-    // call manually without agent impl injected
-    agent->Agent::InitFrom(&pi);
-
-    pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
-    agent->InitFrom(&pi);
+    InitPrototype(qe, agent, spec);
     ctx_->AddPrototype(prototype, agent);
   }
 
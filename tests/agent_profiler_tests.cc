@@ -0,0 +1,77 @@
+#include <stdlib.h>
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "agent_profiler.h"
+#include "mem_back.h"
+#include "test_context.h"
+
+using cyclus::AgentProfiler;
+using cyclus::QueryResult;
+
+class AgentProfilerTests : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    tc.recorder()->RegisterBackend(&b);
+  }
+
+  virtual void TearDown() {
+    tc.recorder()->Close();
+  }
+
+  cyclus::MemBack b;
+  cyclus::TestContext tc;
+};
+
+TEST_F(AgentProfilerTests, RecordsWindows) {
+  TestFacility* fac = tc.trader();
+  fac->prototype("fac");
+  AgentProfiler prof(tc.get(), 2);
+
+  prof.Add(fac, AgentProfiler::TICK, 1.0);
+  prof.Add(fac, AgentProfiler::GET_MATL_BIDS, 0.5);
+  prof.EndStep(0);
+  prof.Add(fac, AgentProfiler::TICK, 2.0);
+  prof.Add(NULL, AgentProfiler::TICK, 8.0);
+  prof.EndStep(1);
+  prof.Add(fac, AgentProfiler::TICK, 4.0);
+  prof.EndStep(2);
+  prof.Flush();
+  tc.recorder()->Flush();
+
+  QueryResult qr = b.Query("AgentProfile", NULL);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(fac->id(), qr.GetVal<int>("AgentId", 0));
+  EXPECT_EQ("Tick", qr.GetVal<std::string>("Phase", 0));
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("Steps", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("Calls", 0));
+  EXPECT_DOUBLE_EQ(3.0, qr.GetVal<double>("Seconds", 0));
+  EXPECT_EQ("GetMatlBids", qr.GetVal<std::string>("Phase", 1));
+  EXPECT_EQ(2, qr.GetVal<int>("Time", 2));
+  EXPECT_EQ(1, qr.GetVal<int>("Steps", 2));
+
+  std::stringstream ss;
+  prof.PrintSummary(ss);
+  std::string summary = ss.str();
+  EXPECT_NE(std::string::npos, summary.find("Tick"));
+  EXPECT_LT(summary.find("Tick"), summary.find("GetMatlBids"));
+}
+
+TEST(AgentProfilerEnvTests, EnvInterval) {
+  unsetenv("CYCLUS_PROFILE");
+  EXPECT_EQ(0, AgentProfiler::EnvInterval());
+  const char* off[] = {"0", "false", "OFF", "-3", "fast", "2x"};
+  for (int i = 0; i < 6; ++i) {
+    setenv("CYCLUS_PROFILE", off[i], 1);
+    EXPECT_EQ(0, AgentProfiler::EnvInterval()) << off[i];
+  }
+  setenv("CYCLUS_PROFILE", "true", 1);
+  EXPECT_EQ(1, AgentProfiler::EnvInterval());
+  setenv("CYCLUS_PROFILE", "12", 1);
+  EXPECT_EQ(12, AgentProfiler::EnvInterval());
+  unsetenv("CYCLUS_PROFILE");
+}
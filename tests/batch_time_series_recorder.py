@@ -0,0 +1,24 @@
+from cyclus.agents import Facility
+from cyclus import lib
+
+
+class BatchTimeSeriesRecorder(Facility):
+
+    def tick(self):
+        lib.record_time_series("Listened", self, 1.0 * self.context.time)
+        lib.record_time_series("Listened", self, 10.0 * self.context.time)
+        lib.record_time_series("Unlistened", self, 5.0)
+
+
+def echo_value(agent, time, value, tsname):
+    print("VALUE {0} {1} {2} {3}".format(tsname, agent.id, time, value))
+
+
+_call_listeners_batch = lib.call_listeners_batch
+
+def echo_batch(tsname, agents, times, values):
+    print("BATCH {0} {1}".format(tsname, len(values)))
+    _call_listeners_batch(tsname, agents, times, values)
+
+lib.call_listeners_batch = echo_batch
+lib.TIME_SERIES_LISTENERS.setdefault("Listened", []).append(echo_value)
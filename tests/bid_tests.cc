@@ -16,6 +16,7 @@ using cyclus::Bid;
 using cyclus::Composition;
 using cyclus::Product;
 using cyclus::Material;
+using cyclus::OfferSpec;
 using cyclus::Request;
 using cyclus::TestContext;
 using std::string;
@@ -61,3 +62,36 @@ TEST(BidTests, ProductGetSet) {
   delete bid;
   delete req;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(BidTests, DeferredOffer) {
+  TestContext tc;
+  TestFacility* fac = tc.trader();
+  Material::Ptr like = tc.mat();
+  Request<Material>* req = tc.NewReq();
+  double qty = like->quantity() / 2;
+
+  Bid<Material>* bid = Bid<Material>::Create(
+      req, OfferSpec<Material>(qty, like), fac,
+      boost::shared_ptr<cyclus::BidPortfolio<Material>>(), false, 1.0);
+  const OfferSpec<Material>& spec = bid->offer_spec();
+  EXPECT_TRUE(spec.deferred());
+  EXPECT_FALSE(spec.materialized());
+  EXPECT_DOUBLE_EQ(qty, spec.qty());
+  EXPECT_EQ(like, spec.like());
+
+  Material::Ptr offer = bid->offer();
+  EXPECT_TRUE(spec.materialized());
+  EXPECT_NE(like, offer);
+  EXPECT_DOUBLE_EQ(qty, offer->quantity());
+  EXPECT_EQ(like->comp(), offer->comp());
+  EXPECT_EQ(offer, bid->offer());
+
+  Bid<Material>* eager = Bid<Material>::Create(req, like, fac);
+  EXPECT_FALSE(eager->offer_spec().deferred());
+  EXPECT_TRUE(eager->offer_spec().materialized());
+  EXPECT_DOUBLE_EQ(like->quantity(), eager->offer_spec().qty());
+
+  delete bid;
+  delete eager;
+}
@@ -19,6 +19,7 @@ using cyclus::Composition;
 using cyclus::Converter;
 using cyclus::Product;
 using cyclus::Material;
+using cyclus::OfferSpec;
 using cyclus::Resource;
 using cyclus::TestContext;
 using cyclus::ExchangeTranslationContext;
@@ -60,6 +61,16 @@ struct MatQualConverter : public Converter<Material> {
   }
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+struct MatQualSpecConverter : public MatQualConverter {
+  virtual double convert_offer(
+      const OfferSpec<Material>& spec,
+      Arc const * a = NULL,
+      ExchangeTranslationContext<Material> const * ctx = NULL) const {
+    return spec.like()->comp()->mass().find(u235)->second * fraction;
+  }
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 struct ProductQualConverter : public Converter<Product> {
   ProductQualConverter() {}
@@ -168,3 +179,31 @@ TEST(CapacityConstraintTests, GenProductQuality) {
   gr = Product::CreateUntracked(quan, "foo");
   EXPECT_DOUBLE_EQ(cc.convert(gr), 0.0);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CapacityConstraintTests, OfferSpec) {
+  TestContext tc;
+  CompMap cm;
+  cm[92235] = val;
+  Composition::Ptr comp = Composition::CreateFromMass(cm);
+  Material::Ptr like = Material::CreateUntracked(0, comp);
+
+  // trivial constraints only need the quantity
+  CapacityConstraint<Material> trivial(val);
+  OfferSpec<Material> spec(quantity, like);
+  EXPECT_DOUBLE_EQ(quantity, trivial.convert(spec));
+  EXPECT_FALSE(spec.materialized());
+
+  // converters reading the spec never create the offer
+  Converter<Material>::Ptr c(new MatQualSpecConverter());
+  CapacityConstraint<Material> qual(val, c);
+  EXPECT_DOUBLE_EQ(val * fraction, qual.convert(spec));
+  EXPECT_FALSE(spec.materialized());
+
+  // other converters see the offer itself
+  c = Converter<Material>::Ptr(new MatQualConverter());
+  CapacityConstraint<Material> legacy(val, c);
+  EXPECT_DOUBLE_EQ(val * fraction, legacy.convert(spec));
+  EXPECT_TRUE(spec.materialized());
+  EXPECT_DOUBLE_EQ(quantity, spec.offer()->quantity());
+}
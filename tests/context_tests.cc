@@ -109,6 +109,38 @@ TEST_F(ContextTests, CreateAgent) {
   EXPECT_EQ(6, DonutShop::destruct_count);
 }
 
+TEST_F(ContextTests, CreateAgents) {
+  Timer ti;
+  Recorder rec;
+  Context* ctx = new Context(&ti, &rec);
+
+  ctx->AddPrototype("dunkin donuts", new DonutShop(ctx, "old fashion"));
+  ctx->AddPrototype("krispy kreme", new DonutShop(ctx, "apple fritter"));
+
+  std::vector<std::string> protos;
+  for (int i = 0; i < 20; ++i) {
+    protos.push_back(i % 3 == 0 ? "krispy kreme" : "dunkin donuts");
+  }
+
+  for (int k = 0; k < 2; ++k) {
+    bool parallel = k == 1;
+    std::vector<Agent*> agents = ctx->CreateAgents(protos, parallel);
+    ASSERT_EQ(protos.size(), agents.size());
+    for (int i = 0; i < agents.size(); ++i) {
+      DonutShop* d = dynamic_cast<DonutShop*>(agents[i]);
+      ASSERT_TRUE(d != NULL);
+      EXPECT_EQ(i % 3 == 0 ? "apple fritter" : "old fashion",
+                d->donut_of_the_day);
+      EXPECT_EQ(agents[0]->id() + i, d->id());
+    }
+  }
+
+  protos.push_back("greenbush bakery");
+  EXPECT_THROW(ctx->CreateAgents(protos, true), cyclus::KeyError);
+
+  delete ctx;
+}
+
 TEST_F(ContextTests, DoubleAgentNameThrow) {
   Timer ti;
   Recorder rec;
@@ -250,6 +250,33 @@ def test_vdeclarfilter_skips_pragmas_and_comments():
     assert not f.isvalid("// a comment")
     assert not f.isvalid("/* a comment */")
 
+def test_vdeclarfilter_shared():
+    """Test VarDeclarationFilter wraps shared state variables in handles"""
+    m = StateAccumulator()
+    m.classes = [(0, "trader")]
+    m.superclasses["trader"] = set()
+    m.access = {tuple(m.classes): "public"}
+    m.var_annotations = {'shared': True}
+    f = VarDeclarationFilter(m)
+    statement, sep = "std::vector<std::string> recipes", ";"
+    assert f.isvalid(statement)
+    f.transform(statement, sep)
+    assert m.context["trader"]["vars"]["recipes"]["type"] == \
+        ("std::vector", "std::string")
+
+    cg = MockCodeGenMachine()
+    cg.local_classname = "trader"
+    cg.context = m.context
+    cg.var_annotations = True
+    f = VarDeclarationFilter(cg)
+    f.isvalid(statement)
+    assert f.transform_pass3(statement, sep).startswith(
+        "cyclus::toolkit::Shared< std::vector<std::string> > recipes;")
+
+    f = SnapshotFilter(cg)
+    f.given_classname = "trader"
+    assert '->AddVal("recipes", *recipes, &cycpp_shape_recipes)' in f.impl()
+
 def test_vdeclarfilter_canonize_alias():
     m = MockMachine()
     f = VarDeclarationFilter(m)
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include "bid.h"
+#include "bid_portfolio.h"
+#include "exchange_arena.h"
+#include "material.h"
+#include "request.h"
+#include "request_portfolio.h"
+#include "resource_helpers.h"
+#include "test_context.h"
+#include "test_agents/test_facility.h"
+
+using cyclus::ArenaPool;
+using cyclus::Bid;
+using cyclus::BidPortfolio;
+using cyclus::ExchangeArena;
+using cyclus::Material;
+using cyclus::Request;
+using cyclus::RequestPortfolio;
+using cyclus::TestContext;
+using test_helpers::get_mat;
+
+namespace {
+
+struct Counted {
+  Counted() { ++live; }
+  ~Counted() { --live; }
+  static int live;
+};
+int Counted::live = 0;
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeArenaTests, PoolClearAndReuse) {
+  ArenaPool<Counted> pool(2);
+  for (int i = 0; i < 5; ++i) {
+    new (pool.Next()) Counted();
+    pool.Commit();
+  }
+  EXPECT_EQ(5, pool.size());
+  EXPECT_EQ(5, Counted::live);
+  EXPECT_EQ(6, pool.capacity());
+
+  pool.Clear();
+  EXPECT_EQ(0, pool.size());
+  EXPECT_EQ(0, Counted::live);
+
+  // memory is kept between rounds
+  new (pool.Next()) Counted();
+  pool.Commit();
+  EXPECT_EQ(6, pool.capacity());
+  pool.Clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeArenaTests, PoolUncommitted) {
+  ArenaPool<Counted> pool;
+  void* p = pool.Next();
+  EXPECT_EQ(0, pool.size());
+  EXPECT_EQ(p, pool.Next());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeArenaTests, Scope) {
+  ExchangeArena<Material> outer;
+  ExchangeArena<Material> inner;
+  EXPECT_TRUE(ExchangeArena<Material>::current() == NULL);
+  {
+    ExchangeArena<Material>::Scope s1(&outer);
+    EXPECT_EQ(&outer, ExchangeArena<Material>::current());
+    {
+      ExchangeArena<Material>::Scope s2(&inner);
+      EXPECT_EQ(&inner, ExchangeArena<Material>::current());
+    }
+    EXPECT_EQ(&outer, ExchangeArena<Material>::current());
+  }
+  EXPECT_TRUE(ExchangeArena<Material>::current() == NULL);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeArenaTests, Portfolios) {
+  TestContext tc;
+  TestFacility* fac = new TestFacility(tc.get());
+  ExchangeArena<Material> arena;
+  {
+    ExchangeArena<Material>::Scope scope(&arena);
+    RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+    Request<Material>* r = rp->AddRequest(get_mat(), fac);
+    BidPortfolio<Material>::Ptr bp(new BidPortfolio<Material>());
+    Bid<Material>* b1 = bp->AddBid(r, get_mat(), fac);
+    Bid<Material>* b2 = bp->AddBid(r, get_mat(), fac);
+    EXPECT_EQ(1, arena.n_requests());
+    EXPECT_EQ(2, arena.n_bids());
+    EXPECT_EQ(r, b1->request());
+    EXPECT_EQ(rp, r->portfolio());
+    EXPECT_EQ(bp, b2->portfolio());
+    ASSERT_EQ(2, bp->bids().size());
+    EXPECT_EQ(b1, bp->bids()[0]);
+    EXPECT_EQ(b2, bp->bids()[1]);
+  }
+  EXPECT_EQ(0, arena.n_requests());
+  EXPECT_EQ(0, arena.n_bids());
+
+  // portfolios made outside of an exchange still own their items
+  RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+  rp->AddRequest(get_mat(), fac);
+  EXPECT_EQ(0, arena.n_requests());
+  delete fac;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeArenaTests, PortfolioOutlivesExchange) {
+  TestContext tc;
+  TestFacility* fac = new TestFacility(tc.get());
+  ExchangeArena<Material> arena;
+  RequestPortfolio<Material>::Ptr kept;
+  BidPortfolio<Material>::Ptr kept_bids;
+  {
+    ExchangeArena<Material>::Scope scope(&arena);
+    RequestPortfolio<Material>::Ptr dropped(new RequestPortfolio<Material>());
+    dropped->AddRequest(get_mat(), fac);
+    kept.reset(new RequestPortfolio<Material>());
+    Request<Material>* r = kept->AddRequest(get_mat(), fac);
+    kept_bids.reset(new BidPortfolio<Material>());
+    kept_bids->AddBid(r, get_mat(), fac);
+  }
+  EXPECT_EQ(0, arena.n_requests());
+  EXPECT_EQ(0, arena.n_bids());
+
+  // the requests and bids of surviving portfolios are still valid
+  ASSERT_EQ(1, kept->requests().size());
+  Request<Material>* r = kept->requests()[0];
+  EXPECT_EQ(kept, r->portfolio());
+  EXPECT_EQ(fac, r->requester());
+  ASSERT_EQ(1, kept_bids->bids().size());
+  EXPECT_EQ(r, kept_bids->bids()[0]->request());
+  EXPECT_EQ(kept_bids, kept_bids->bids()[0]->portfolio());
+
+  // and the arena carries on with new storage
+  {
+    ExchangeArena<Material>::Scope scope(&arena);
+    RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+    rp->AddRequest(get_mat(), fac);
+    EXPECT_EQ(1, arena.n_requests());
+  }
+  EXPECT_EQ(r, kept->requests()[0]);
+  EXPECT_EQ(fac, kept->requests()[0]->requester());
+  kept.reset();
+  kept_bids.reset();
+  delete fac;
+}
@@ -138,7 +138,7 @@ TEST_F(ExchangeContextTests, AddBid1) {
   ExchangeContext<Resource> context;
   context.AddRequestPortfolio(rp1);
 
-  EXPECT_TRUE(context.bids_by_request[req1].empty());
+  EXPECT_TRUE(context.bids_by_request[req1->id()].empty());
 
   BidPortfolio<Resource>::Ptr bp1(new BidPortfolio<Resource>());
   Bid<Resource>* bid = bp1->AddBid(req1, get_mat(), fac1);
@@ -149,23 +149,28 @@ TEST_F(ExchangeContextTests, AddBid1) {
   vp.push_back(bp1);
   EXPECT_EQ(vp, context.bids);
 
-  EXPECT_EQ(1, context.bids_by_request[req1].size());
+  EXPECT_EQ(1, context.bids_by_request[req1->id()].size());
 
   std::vector<Bid<Resource>*> vr;
   vr.push_back(bid);
-  EXPECT_EQ(vr, context.bids_by_request[req1]);
+  EXPECT_EQ(vr, context.bids_by_request[req1->id()]);
 
   EXPECT_EQ(1, context.bidders.size());
   std::set<Trader*> bidders;
   bidders.insert(fac1);
   EXPECT_EQ(bidders, context.bidders);
 
+  EXPECT_EQ(0, req1->id());
+  EXPECT_EQ(0, bid->id());
+  ASSERT_EQ(1, context.prefs.size());
+  EXPECT_DOUBLE_EQ(req1->preference(), context.prefs[bid->id()]);
+
   PrefMap<Resource>::type obs;
   obs[req1].insert(std::make_pair(bid, req1->preference()));
-  EXPECT_EQ(context.trader_prefs[req1->requester()], obs);
+  EXPECT_EQ(context.trader_prefs(req1->requester()).legacy(), obs);
   obs.clear();
   obs[req1].insert(std::make_pair(bid, req1->preference() * 0.1));
-  EXPECT_NE(context.trader_prefs[req1->requester()], obs);
+  EXPECT_NE(context.trader_prefs(req1->requester()).legacy(), obs);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -175,8 +180,8 @@ TEST_F(ExchangeContextTests, AddBid2) {
   context.AddRequestPortfolio(rp1);
   context.AddRequestPortfolio(rp2);
 
-  EXPECT_TRUE(context.bids_by_request[req1].empty());
-  EXPECT_TRUE(context.bids_by_request[req2].empty());
+  EXPECT_TRUE(context.bids_by_request[req1->id()].empty());
+  EXPECT_TRUE(context.bids_by_request[req2->id()].empty());
 
   // bid1 and bid2 are from one bidder (fac1)
   BidPortfolio<Resource>::Ptr bp1(new BidPortfolio<Resource>());
@@ -200,10 +205,10 @@ TEST_F(ExchangeContextTests, AddBid2) {
 
   vreq1.push_back(bid1);
   vreq2.push_back(bid2);
-  EXPECT_EQ(1, context.bids_by_request[req1].size());
-  EXPECT_EQ(1, context.bids_by_request[req2].size());
-  EXPECT_EQ(vreq1, context.bids_by_request[req1]);
-  EXPECT_EQ(vreq2, context.bids_by_request[req2]);
+  EXPECT_EQ(1, context.bids_by_request[req1->id()].size());
+  EXPECT_EQ(1, context.bids_by_request[req2->id()].size());
+  EXPECT_EQ(vreq1, context.bids_by_request[req1->id()]);
+  EXPECT_EQ(vreq2, context.bids_by_request[req2->id()]);
 
   // add bids from second bidder
   context.AddBidPortfolio(bp2);
@@ -213,10 +218,10 @@ TEST_F(ExchangeContextTests, AddBid2) {
 
   vreq1.push_back(bid3);
   vreq2.push_back(bid4);
-  EXPECT_EQ(2, context.bids_by_request[req1].size());
-  EXPECT_EQ(2, context.bids_by_request[req2].size());
-  EXPECT_EQ(vreq1, context.bids_by_request[req1]);
-  EXPECT_EQ(vreq2, context.bids_by_request[req2]);
+  EXPECT_EQ(2, context.bids_by_request[req1->id()].size());
+  EXPECT_EQ(2, context.bids_by_request[req2->id()].size());
+  EXPECT_EQ(vreq1, context.bids_by_request[req1->id()]);
+  EXPECT_EQ(vreq2, context.bids_by_request[req2->id()]);
 
   EXPECT_EQ(2, context.bidders.size());
   std::set<Trader*> bidders;
@@ -224,3 +229,44 @@ TEST_F(ExchangeContextTests, AddBid2) {
   bidders.insert(fac2);
   EXPECT_EQ(bidders, context.bidders);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ExchangeContextTests, PrefView) {
+  ExchangeContext<Resource> context;
+  context.AddRequestPortfolio(rp1);
+  context.AddRequestPortfolio(rp2);
+
+  BidPortfolio<Resource>::Ptr bp1(new BidPortfolio<Resource>());
+  Bid<Resource>* bid1 = bp1->AddBid(req1, get_mat(), fac2);
+  Bid<Resource>* bid2 = bp1->AddBid(req2, get_mat(), fac2);
+  context.AddBidPortfolio(bp1);
+
+  PrefMap<Resource> prefs = context.trader_prefs(fac1);
+  ASSERT_EQ(1, prefs.size());
+  EXPECT_EQ(bid1, prefs.bid(0));
+  EXPECT_EQ(req1, prefs.request(0));
+  EXPECT_EQ(bid1->id(), prefs.id(0));
+  EXPECT_DOUBLE_EQ(pref, prefs.pref(0));
+
+  prefs.pref(0) = 2 * pref;
+  EXPECT_DOUBLE_EQ(2 * pref, context.prefs[bid1->id()]);
+  EXPECT_DOUBLE_EQ(pref, context.prefs[bid2->id()]);
+
+  // changes through the nested map are written back on the next access
+  prefs.legacy()[req1][bid1] = 3 * pref;
+  EXPECT_DOUBLE_EQ(3 * pref, prefs.pref(0));
+  prefs.legacy()[req1][bid1] = 4 * pref;
+  prefs.Sync();
+  EXPECT_DOUBLE_EQ(4 * pref, context.prefs[bid1->id()]);
+
+  // erased arcs get a preference of 0 and entries for unknown bids are ignored
+  prefs.legacy()[req1].erase(bid1);
+  prefs.legacy()[req2][bid2] = 5 * pref;
+  prefs.Sync();
+  EXPECT_DOUBLE_EQ(0, context.prefs[bid1->id()]);
+  EXPECT_DOUBLE_EQ(pref, context.prefs[bid2->id()]);
+  prefs.legacy().clear();
+  EXPECT_DOUBLE_EQ(0, prefs.pref(0));
+
+  EXPECT_TRUE(context.trader_prefs(NULL).empty());
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 #include "cyc_limits.h"
 #include "error.h"
 #include "exchange_graph.h"
@@ -9,7 +11,9 @@ using cyclus::ExchangeGraph;
 using cyclus::Match;
 using cyclus::ExchangeNode;
 using cyclus::ExchangeNodeGroup;
+using cyclus::ReadGraph;
 using cyclus::RequestGroup;
+using cyclus::WriteGraph;
 using std::vector;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -130,3 +134,92 @@ TEST(ExGraphTests, AddMatch) {
   ASSERT_EQ(1, g.matches().size());
   EXPECT_EQ(match, g.matches().at(0));
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, WriteReadGraph) {
+  ExchangeGraph g;
+
+  RequestGroup::Ptr rg(new RequestGroup(5));
+  ExchangeNode::Ptr u1(new ExchangeNode(5, false, "spam", 1));
+  ExchangeNode::Ptr u2(new ExchangeNode(2, true, "eggs", 1));
+  rg->AddExchangeNode(u1);
+  rg->AddExchangeNode(u2);
+  rg->AddCapacity(5);
+  g.AddRequestGroup(rg);
+
+  ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+  ExchangeNode::Ptr v1(new ExchangeNode(3, true, "spam", 2));
+  ExchangeNode::Ptr v2(new ExchangeNode(3, true, "eggs", 2));
+  sg->AddExchangeNode(v1);
+  sg->AddExchangeNode(v2);
+  vector<ExchangeNode::Ptr> excl;
+  excl.push_back(v1);
+  excl.push_back(v2);
+  sg->AddExclGroup(excl);
+  sg->AddCapacity(4);
+  sg->AddCapacity(10);
+  g.AddSupplyGroup(sg);
+
+  Arc a1(u1, v1);
+  a1.pref(2);
+  u1->prefs[a1] = 2;
+  u1->unit_capacities[a1].push_back(1);
+  v1->unit_capacities[a1].push_back(1);
+  v1->unit_capacities[a1].push_back(0.5);
+  g.AddArc(a1);
+  Arc a2(u2, v2);
+  a2.pref(0.5);
+  u2->prefs[a2] = 0.5;
+  u2->unit_capacities[a2].push_back(1);
+  v2->unit_capacities[a2].push_back(1);
+  v2->unit_capacities[a2].push_back(2);
+  g.AddArc(a2);
+
+  std::stringstream ss;
+  WriteGraph(g, ss);
+  ExchangeGraph::Ptr h = ReadGraph(ss);
+
+  ASSERT_EQ(1, h->request_groups().size());
+  ASSERT_EQ(1, h->supply_groups().size());
+  ASSERT_EQ(2, h->arcs().size());
+
+  RequestGroup::Ptr hrg = h->request_groups()[0];
+  EXPECT_DOUBLE_EQ(5, hrg->qty());
+  EXPECT_EQ(rg->capacities(), hrg->capacities());
+  EXPECT_EQ(1, hrg->excl_node_groups().size());
+  ASSERT_EQ(2, hrg->nodes().size());
+  ExchangeNode::Ptr hu2 = hrg->nodes()[1];
+  EXPECT_DOUBLE_EQ(2, hu2->qty);
+  EXPECT_TRUE(hu2->exclusive);
+  EXPECT_EQ("eggs", hu2->commod);
+  EXPECT_EQ(1, hu2->agent_id);
+  EXPECT_EQ(hrg.get(), hu2->group);
+
+  ExchangeNodeGroup::Ptr hsg = h->supply_groups()[0];
+  EXPECT_EQ(sg->capacities(), hsg->capacities());
+  ASSERT_EQ(1, hsg->excl_node_groups().size());
+  EXPECT_EQ(hsg->nodes(), hsg->excl_node_groups()[0]);
+
+  const Arc& ha2 = h->arcs()[1];
+  EXPECT_EQ(hu2, ha2.unode());
+  EXPECT_EQ(hsg->nodes()[1], ha2.vnode());
+  EXPECT_DOUBLE_EQ(0.5, ha2.pref());
+  EXPECT_TRUE(ha2.exclusive());
+  EXPECT_DOUBLE_EQ(0.5, ha2.unode()->prefs[ha2]);
+  EXPECT_EQ(v2->unit_capacities[a2], ha2.vnode()->unit_capacities[ha2]);
+  EXPECT_EQ(1, h->node_arc_map()[hu2].size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, ReadBadGraph) {
+  std::stringstream bad("not a graph");
+  EXPECT_THROW(ReadGraph(bad), cyclus::IOError);
+
+  ExchangeGraph g;
+  g.AddRequestGroup(RequestGroup::Ptr(new RequestGroup(1)));
+  std::stringstream ss;
+  WriteGraph(g, ss);
+  std::string s = ss.str();
+  std::stringstream truncated(s.substr(0, s.size() - 2));
+  EXPECT_THROW(ReadGraph(truncated), cyclus::IOError);
+}
@@ -254,3 +254,319 @@ TEST(Hdf5BackTest, Tables) {
   EXPECT_LE(1, tabs.size());
   EXPECT_EQ(1, tabs.count("IntTable"));
 }
+
+TEST_F(Hdf5BackTests, VLVectorInt) {
+  std::vector<int> x;
+  x.push_back(6);
+  x.push_back(28);
+  std::vector<int> y;
+  y.push_back(42);
+  TestBasic<std::vector<int> >("VLVectorInt", x, y);
+}
+
+TEST_F(Hdf5BackTests, VLString) {
+  TestBasicString("VLString", "wakka", "jawaka");
+}
+
+TEST_F(Hdf5BackTests, VLBlob) {
+  TestBasicBlob("VLBlob", cyclus::Blob("wakka"), cyclus::Blob("jawaka"));
+}
+
+TEST(Hdf5BackTest, VLBatches) {
+  using std::map;
+  using std::string;
+  using std::vector;
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  typedef map<string, double> Comp;
+  FileDeleter fd(path);
+
+  // many rows sharing a few values, written over several flushes
+  int n = 100;
+  vector<Comp> vals(3);
+  vals[0]["U235"] = 0.05;
+  vals[0]["U238"] = 0.95;
+  vals[1]["Pu239"] = 1.0;
+  {
+    Recorder m;
+    Hdf5Back back(path);
+    m.RegisterBackend(&back);
+    for (int i = 0; i < n; ++i) {
+      m.NewDatum("Comps")
+          ->AddVal("i", i)
+          ->AddVal("comp", vals[i % vals.size()])
+          ->Record();
+      if (i % 30 == 0)
+        m.Flush();
+    }
+    m.Close();
+
+    cyclus::QueryResult qr = back.Query("Comps", NULL);
+    ASSERT_EQ(n, qr.rows.size());
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(vals[qr.GetVal<int>("i", i) % vals.size()],
+                qr.GetVal<Comp>("comp", i));
+    }
+  }
+
+  // values are stored only once and can be read back from a new backend
+  hid_t file = H5Fopen(path, H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t keys = H5Dopen2(file, "MapStringDoubleKeys", H5P_DEFAULT);
+  hid_t space = H5Dget_space(keys);
+  EXPECT_EQ(vals.size(), H5Sget_simple_extent_npoints(space));
+  H5Sclose(space);
+  H5Dclose(keys);
+  H5Fclose(file);
+
+  Hdf5Back back(path);
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("i", "==", 31));
+  cyclus::QueryResult qr = back.Query("Comps", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(vals[1], qr.GetVal<Comp>("comp", 0));
+}
+
+TEST(Hdf5BackTest, ChunkingAndFilters) {
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  // rows are written over several notifies, so the extents grow past them
+  int n = 1000;
+  {
+    Recorder m;
+    m.set_dump_count(64);
+    Hdf5Back back(path);
+    EXPECT_THROW(back.set_compression(10), cyclus::ValueError);
+    back.set_chunk_bytes(1000);
+    back.set_compression(0);
+    m.RegisterBackend(&back);
+    for (int i = 0; i < n; ++i) {
+      m.NewDatum("Raw")->AddVal("i", i)->AddVal("x", 2.0 * i)->Record();
+    }
+    back.set_compression(4, false);
+    m.NewDatum("Packed")->AddVal("i", 42)->Record();
+    m.Close();
+
+    cyclus::QueryResult qr = back.Query("Raw", NULL);
+    ASSERT_EQ(n, qr.rows.size());
+    EXPECT_EQ(n - 1, qr.GetVal<int>("i", n - 1));
+  }
+
+  // closing trims each table to its rows
+  hid_t file = H5Fopen(path, H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t dset = H5Dopen2(file, "Raw", H5P_DEFAULT);
+  hid_t space = H5Dget_space(dset);
+  EXPECT_EQ(n, H5Sget_simple_extent_npoints(space));
+  hid_t plist = H5Dget_create_plist(dset);
+  hsize_t chunk;
+  H5Pget_chunk(plist, 1, &chunk);
+  hid_t dtype = H5Dget_type(dset);
+  EXPECT_EQ(1000 / H5Tget_size(dtype), chunk);
+  H5Tclose(dtype);
+  EXPECT_EQ(0, H5Pget_nfilters(plist));
+  H5Pclose(plist);
+  H5Sclose(space);
+  H5Dclose(dset);
+
+  dset = H5Dopen2(file, "Packed", H5P_DEFAULT);
+  plist = H5Dget_create_plist(dset);
+  ASSERT_EQ(1, H5Pget_nfilters(plist));
+  unsigned int flags;
+  size_t nelmts = 1;
+  unsigned int level;
+  EXPECT_EQ(H5Z_FILTER_DEFLATE, H5Pget_filter2(plist, 0, &flags, &nelmts,
+                                               &level, 0, NULL, NULL));
+  EXPECT_EQ(4, level);
+  H5Pclose(plist);
+  H5Dclose(dset);
+  H5Fclose(file);
+
+  Hdf5Back back(path);
+  cyclus::QueryResult qr = back.Query("Raw", NULL);
+  EXPECT_EQ(n, qr.rows.size());
+}
+
+TEST(Hdf5BackTest, DirectChunkWrites) {
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  // chunks filtered by the backend read back through the library's filters
+  int n = 1000;
+  {
+    Recorder m;
+    m.set_dump_count(64);
+    Hdf5Back back(path);
+    back.set_chunk_bytes(1000);
+    back.set_direct_chunk_writes(true);
+    m.RegisterBackend(&back);
+    for (int i = 0; i < n; ++i) {
+      m.NewDatum("Shuffled")->AddVal("i", i)->AddVal("x", 0.5 * i)->Record();
+      if (i == n / 2) {
+        m.Flush();
+        cyclus::QueryResult qr = back.Query("Shuffled", NULL);
+        ASSERT_EQ(i + 1, qr.rows.size());
+        EXPECT_EQ(i, qr.GetVal<int>("i", i));
+      }
+    }
+    back.set_compression(0);
+    for (int i = 0; i < n; ++i) {
+      m.NewDatum("Plain")->AddVal("i", i)->Record();
+    }
+    m.Close();
+  }
+
+  {
+    Hdf5Back back(path);
+    cyclus::QueryResult qr = back.Query("Shuffled", NULL);
+    ASSERT_EQ(n, qr.rows.size());
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(i, qr.GetVal<int>("i", i));
+      EXPECT_DOUBLE_EQ(0.5 * i, qr.GetVal<double>("x", i));
+    }
+    qr = back.Query("Plain", NULL);
+    ASSERT_EQ(n, qr.rows.size());
+    EXPECT_EQ(n - 1, qr.GetVal<int>("i", n - 1));
+  }
+
+  // appending to a table that ends in a partial chunk keeps its last rows
+  {
+    Recorder m;
+    Hdf5Back back(path);
+    back.set_direct_chunk_writes(true);
+    m.RegisterBackend(&back);
+    for (int i = n; i < n + 100; ++i) {
+      m.NewDatum("Shuffled")->AddVal("i", i)->AddVal("x", 0.5 * i)->Record();
+    }
+    m.Close();
+  }
+  Hdf5Back back(path);
+  cyclus::QueryResult qr = back.Query("Shuffled", NULL);
+  ASSERT_EQ(n + 100, qr.rows.size());
+  for (int i = 0; i < n + 100; ++i) {
+    EXPECT_EQ(i, qr.GetVal<int>("i", i));
+  }
+}
+
+TEST(Hdf5BackTest, QueryManyChunks) {
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  // small chunks so that the rows are decoded from many chunks at once
+  int n = 2000;
+  Recorder m;
+  Hdf5Back back(path);
+  back.set_chunk_bytes(256);
+  m.RegisterBackend(&back);
+  for (int i = 0; i < n; ++i) {
+    std::vector<int> v(i % 7, i);
+    m.NewDatum("Many")
+        ->AddVal("i", i)
+        ->AddVal("name", std::string(i % 5 + 1, 'a' + i % 26))
+        ->AddVal("v", v)
+        ->Record();
+  }
+  m.Close();
+
+  cyclus::QueryResult qr = back.Query("Many", NULL);
+  ASSERT_EQ(n, qr.rows.size());
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(i, qr.GetVal<int>("i", i));
+    EXPECT_EQ(std::string(i % 5 + 1, 'a' + i % 26),
+              qr.GetVal<std::string>("name", i));
+    EXPECT_EQ(std::vector<int>(i % 7, i), qr.GetVal<std::vector<int> >("v", i));
+  }
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("i", ">=", 1000));
+  conds.push_back(cyclus::Cond("name", "==", std::string("bb")));
+  qr = back.Query("Many", &conds);
+  int last = 0;
+  for (int k = 0; k < qr.rows.size(); ++k) {
+    int i = qr.GetVal<int>("i", k);
+    EXPECT_LT(last, i);
+    EXPECT_EQ(1, i % 26);
+    last = i;
+  }
+  EXPECT_LT(0, qr.rows.size());
+
+  // values are read back from the file once the cache has been dropped
+  EXPECT_EQ(100000, back.vl_cache_values());
+  back.set_vl_cache_values(0);
+  qr = back.Query("Many", NULL);
+  ASSERT_EQ(n, qr.rows.size());
+  EXPECT_EQ(std::string(1998 % 5 + 1, 'a' + 1998 % 26),
+            qr.GetVal<std::string>("name", 1998));
+  EXPECT_EQ(std::vector<int>(1998 % 7, 1998),
+            qr.GetVal<std::vector<int> >("v", 1998));
+}
+
+TEST(Hdf5BackTest, Columnar) {
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  int n = 300;
+  {
+    Recorder m;
+    m.set_dump_count(64);
+    Hdf5Back back(path);
+    back.set_columnar(true);
+    back.set_chunk_bytes(512);
+    m.RegisterBackend(&back);
+    for (int i = 0; i < n; ++i) {
+      m.NewDatum("Cols")
+          ->AddVal("i", i)
+          ->AddVal("x", 0.25 * i)
+          ->AddVal("name", std::string(i % 3 + 1, 'z'))
+          ->Record();
+    }
+    m.Close();
+
+    std::map<std::string, cyclus::DbTypes> types = back.ColumnTypes("Cols");
+    EXPECT_EQ(cyclus::INT, types["i"]);
+    EXPECT_EQ(cyclus::DOUBLE, types["x"]);
+    EXPECT_EQ(cyclus::VL_STRING, types["name"]);
+    std::list<cyclus::ColumnInfo> schema = back.Schema("Cols");
+    ASSERT_EQ(4, schema.size());
+    EXPECT_EQ("SimId", schema.front().col);
+    EXPECT_EQ("name", schema.back().col);
+  }
+
+  // each column is its own dataset
+  hid_t file = H5Fopen(path, H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t col = H5Dopen2(file, "/Cols/x", H5P_DEFAULT);
+  ASSERT_LE(0, col);
+  hid_t space = H5Dget_space(col);
+  EXPECT_EQ(n, H5Sget_simple_extent_npoints(space));
+  H5Sclose(space);
+  H5Dclose(col);
+  H5Fclose(file);
+
+  // existing tables keep their layout when more rows are added
+  {
+    Recorder m;
+    Hdf5Back back(path);
+    m.RegisterBackend(&back);
+    m.NewDatum("Cols")
+        ->AddVal("i", n)
+        ->AddVal("x", 0.25 * n)
+        ->AddVal("name", std::string("zz"))
+        ->Record();
+    m.NewDatum("Rows")->AddVal("i", 1)->Record();
+    m.Close();
+  }
+  Hdf5Back back(path);
+  EXPECT_EQ(1, back.Query("Rows", NULL).rows.size());
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("name", "==", std::string("zz")));
+  cyclus::QueryResult qr = back.Query("Cols", &conds);
+  ASSERT_EQ(n / 3 + 1, qr.rows.size());
+  for (int k = 0; k < qr.rows.size(); ++k) {
+    int i = qr.GetVal<int>("i", k);
+    EXPECT_TRUE(i == n || i % 3 == 1);
+    EXPECT_DOUBLE_EQ(0.25 * i, qr.GetVal<double>("x", k));
+  }
+}
@@ -0,0 +1,173 @@
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/uuid/uuid_generators.hpp>
+#include <gtest/gtest.h>
+
+#include "blob.h"
+#include "error.h"
+#include "mem_back.h"
+#include "recorder.h"
+
+class MemBackTests : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    b = new cyclus::MemBack();
+    r.RegisterBackend(b);
+  }
+
+  virtual void TearDown() {
+    r.Close();
+    delete b;
+  }
+  cyclus::MemBack* b;
+  cyclus::Recorder r;
+};
+
+TEST_F(MemBackTests, ReadWrite) {
+  typedef std::map<std::string, double> Comp;
+  Comp c;
+  c["U235"] = 0.7;
+  std::vector<int> shape(1, 10);
+  r.NewDatum("Things")
+      ->AddVal("i", 42)
+      ->AddVal("x", 2.5)
+      ->AddVal("name", std::string("apple"), &shape)
+      ->AddVal("blob", cyclus::Blob("wakka"))
+      ->AddVal("comp", c)
+      ->Record();
+  r.Flush();
+
+  cyclus::QueryResult qr = b->Query("Things", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(42, qr.GetVal<int>("i"));
+  EXPECT_DOUBLE_EQ(2.5, qr.GetVal<double>("x"));
+  EXPECT_EQ("apple", qr.GetVal<std::string>("name"));
+  EXPECT_EQ(cyclus::Blob("wakka"), qr.GetVal<cyclus::Blob>("blob"));
+  EXPECT_EQ(c, qr.GetVal<Comp>("comp"));
+  EXPECT_EQ(r.sim_id(), qr.GetVal<boost::uuids::uuid>("SimId"));
+
+  std::map<std::string, cyclus::DbTypes> types = b->ColumnTypes("Things");
+  EXPECT_EQ(cyclus::INT, types["i"]);
+  EXPECT_EQ(cyclus::MAP_STRING_DOUBLE, types["comp"]);
+  std::list<cyclus::ColumnInfo> schema = b->Schema("Things");
+  ASSERT_EQ(6, schema.size());
+  std::list<cyclus::ColumnInfo>::iterator it = schema.begin();
+  EXPECT_EQ("SimId", it->col);
+  std::advance(it, 3);
+  EXPECT_EQ("name", it->col);
+  EXPECT_EQ(shape, it->shape);
+
+  EXPECT_EQ(1, b->Tables().count("Things"));
+  EXPECT_THROW(b->Query("Nothing", NULL), cyclus::ValueError);
+}
+
+TEST_F(MemBackTests, Conds) {
+  for (int i = 0; i < 100; ++i) {
+    r.NewDatum("Agents")
+        ->AddVal("AgentId", i)
+        ->AddVal("Kind", std::string(i % 2 == 0 ? "Facility" : "Region"))
+        ->Record();
+  }
+  r.Flush();
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("Kind", "==", std::string("Region")));
+  conds.push_back(cyclus::Cond("AgentId", ">", 90));
+  conds.push_back(cyclus::Cond("NotAField", "==", 1));
+  cyclus::QueryResult qr = b->Query("Agents", &conds);
+  ASSERT_EQ(5, qr.rows.size());
+  for (int k = 0; k < qr.rows.size(); ++k) {
+    EXPECT_EQ(91 + 2 * k, qr.GetVal<int>("AgentId", k));
+  }
+
+  // the index built by the first query follows later rows
+  r.NewDatum("Agents")
+      ->AddVal("AgentId", 100)
+      ->AddVal("Kind", std::string("Region"))
+      ->Record();
+  r.Flush();
+  qr = b->Query("Agents", &conds);
+  EXPECT_EQ(6, qr.rows.size());
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("AgentId", "==", 7));
+  qr = b->Query("Agents", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ("Region", qr.GetVal<std::string>("Kind"));
+  conds[0] = cyclus::Cond("AgentId", "==", 1000);
+  EXPECT_EQ(0, b->Query("Agents", &conds).rows.size());
+}
+
+TEST_F(MemBackTests, Hdf5Types) {
+  typedef std::pair<std::string, std::vector<double> > Pair;
+  Pair p("x", std::vector<double>(3, 1.5));
+  std::set<float> fs;
+  fs.insert(2.5);
+  r.NewDatum("Hdf5Only")->AddVal("p", p)->AddVal("fs", fs)->Record();
+  r.Flush();
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("p", "==", p));
+  cyclus::QueryResult qr = b->Query("Hdf5Only", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(p, qr.GetVal<Pair>("p"));
+  EXPECT_EQ(fs, qr.GetVal<std::set<float> >("fs"));
+  EXPECT_EQ(cyclus::SET_FLOAT, b->ColumnTypes("Hdf5Only")["fs"]);
+}
+
+TEST_F(MemBackTests, WrongTypes) {
+  r.NewDatum("Mixed")->AddVal("x", 1)->Record();
+  r.NewDatum("Mixed")->AddVal("x", 1.0)->Record();
+  EXPECT_THROW(r.Flush(), cyclus::ValueError);
+}
+
+class CountingBackend : public cyclus::CondInjector {
+ public:
+  CountingBackend(cyclus::QueryableBackend* b)
+      : cyclus::CondInjector(b, std::vector<cyclus::Cond>()),
+        nqueries(0) {}
+
+  virtual cyclus::QueryResult Query(std::string table,
+                                    std::vector<cyclus::Cond>* conds) {
+    ++nqueries;
+    return cyclus::CondInjector::Query(table, conds);
+  }
+
+  int nqueries;
+};
+
+TEST_F(MemBackTests, QueryCache) {
+  for (int t = 0; t < 3; ++t) {
+    for (int id = 0; id < 50; ++id) {
+      r.NewDatum("AgentStateFoo")
+          ->AddVal("AgentId", id)
+          ->AddVal("SimTime", t)
+          ->AddVal("Val", 10 * id + t)
+          ->Record();
+    }
+  }
+  r.NewDatum("Bar")->AddVal("x", 1)->Record();
+  r.Flush();
+
+  CountingBackend counted(b);
+  cyclus::QueryCache cache(&counted);
+  std::vector<cyclus::Cond> restrict;
+  restrict.push_back(cyclus::Cond("SimTime", "==", 1));
+  cache.Restrict("AgentState", restrict);
+
+  for (int id = 0; id < 50; ++id) {
+    std::vector<cyclus::Cond> conds;
+    conds.push_back(cyclus::Cond("AgentId", "==", id));
+    cyclus::QueryResult qr = cache.Query("AgentStateFoo", &conds);
+    ASSERT_EQ(1, qr.rows.size());
+    EXPECT_EQ(10 * id + 1, qr.GetVal<int>("Val"));
+  }
+  EXPECT_EQ(1, cache.Query("Bar", NULL).rows.size());
+  EXPECT_EQ(2, counted.nqueries);
+
+  EXPECT_THROW(cache.Query("Nothing", NULL), cyclus::ValueError);
+  EXPECT_EQ(2, counted.nqueries);
+}
@@ -163,6 +163,37 @@ TEST(RecorderTest, Manager_CloseFlushing) {
   EXPECT_EQ(back1.notify_count, 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(RecorderTest, Manager_Staging) {
+  using cyclus::Recorder;
+  TestBack back;
+  TestBack stage;
+
+  Recorder m;
+  m.set_dump_count(2);
+  m.RegisterBackend(&back);
+  m.RegisterStagingBackend(&stage);
+
+  m.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("monkey"))
+      ->Record();
+
+  EXPECT_EQ(back.notify_count, 0);
+  EXPECT_EQ(stage.notify_count, 1);
+  ASSERT_EQ(stage.flush_count, 1);
+  EXPECT_EQ(stage.data[0]->title(), "DumbTitle");
+
+  m.UnregisterStagingBackend(&stage);
+  m.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("elephant"))
+      ->Record();
+
+  EXPECT_EQ(back.notify_count, 1);
+  EXPECT_EQ(stage.notify_count, 1);
+  m.Close();
+  EXPECT_FALSE(stage.flushed);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(RecorderTest, Datum_record) {
   using cyclus::Datum;
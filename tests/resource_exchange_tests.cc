@@ -62,6 +62,7 @@ class Requester: public TestFacility {
   }
 
   // increments counter and squares all preferences
+  using TestFacility::AdjustMatlPrefs;
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {
     std::map<Request<Material>*,
              std::map<Bid<Material>*, double> >::iterator p_it;
@@ -208,13 +209,13 @@ TEST_F(ResourceExchangeTests, Bids) {
   const cyclus::BidPortfolio<Material>& rhs = *obsvp[0];
   EXPECT_TRUE(BPEq(*bp, *obsvp[0]));
 
-  const std::vector<Bid<Material>*>& obsvb = ctx.bids_by_request[req];
+  const std::vector<Bid<Material>*>& obsvb = ctx.bids_by_request[req->id()];
   EXPECT_EQ(1, obsvb.size());
   std::vector<Bid<Material>*> vb;
   vb.push_back(bid);
   EXPECT_EQ(vb, obsvb);
 
-  const std::vector<Bid<Material>*>& obsvb1 = ctx.bids_by_request[req1];
+  const std::vector<Bid<Material>*>& obsvb1 = ctx.bids_by_request[req1->id()];
   EXPECT_EQ(1, obsvb1.size());
   vb.clear();
   vb.push_back(bid1);
@@ -223,6 +224,51 @@ TEST_F(ResourceExchangeTests, Bids) {
   clone->Decommission();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, SupplyCommods) {
+  ExchangeContext<Material>& ctx = exchng->ex_ctx();
+  RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+  req = rp->AddRequest(mat, reqr, commod, pref);
+  ctx.AddRequestPortfolio(rp);
+
+  Bidder* supplier = dynamic_cast<Bidder*>(Bidder(tc.get(), commod).Clone());
+  Bidder* other = dynamic_cast<Bidder*>(Bidder(tc.get(), "other").Clone());
+  Bidder* undeclared = dynamic_cast<Bidder*>(Bidder(tc.get(), "").Clone());
+  supplier->port_.reset(new BidPortfolio<Material>());
+  other->port_.reset(new BidPortfolio<Material>());
+  undeclared->port_.reset(new BidPortfolio<Material>());
+  supplier->Build(NULL);
+  other->Build(NULL);
+  undeclared->Build(NULL);
+
+  std::set<std::string> commods;
+  commods.insert(commod);
+  tc.get()->SupplyCommods(supplier, commods);
+  commods.clear();
+  commods.insert("other");
+  tc.get()->SupplyCommods(other, commods);
+  EXPECT_EQ(1, tc.get()->commod_suppliers(commod).count(supplier));
+  EXPECT_EQ(0, tc.get()->undeclared_traders().count(supplier));
+  EXPECT_EQ(1, tc.get()->undeclared_traders().count(undeclared));
+
+  exchng->AddAllBids();
+  EXPECT_EQ(1, supplier->bid_ctr_);
+  EXPECT_EQ(0, other->bid_ctr_);
+  EXPECT_EQ(1, undeclared->bid_ctr_);
+
+  // traders that forget their commodities are asked for bids again
+  tc.get()->ClearSupplyCommods(other);
+  ResourceExchange<Material> next(tc.get());
+  next.ex_ctx().AddRequestPortfolio(rp);
+  next.AddAllBids();
+  EXPECT_EQ(1, other->bid_ctr_);
+
+  supplier->Decommission();
+  EXPECT_TRUE(tc.get()->commod_suppliers(commod).empty());
+  other->Decommission();
+  undeclared->Decommission();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(ResourceExchangeTests, PrefCalls) {
   Facility* parent = dynamic_cast<Facility*>(reqr->Clone());
@@ -309,15 +355,15 @@ TEST_F(ResourceExchangeTests, PrefValues) {
   cobs[creq].insert(std::make_pair(cbid, creq->preference()));
 
   ExchangeContext<Material>& context = exchng->ex_ctx();
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.trader_prefs(parent).legacy(), pobs);
+  EXPECT_EQ(context.trader_prefs(child).legacy(), cobs);
 
   EXPECT_NO_THROW(exchng->AdjustAll());
 
   pobs[preq].begin()->second = std::pow(preq->preference(), 2);
   cobs[creq].begin()->second = std::pow(std::pow(creq->preference(), 2), 2);
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.trader_prefs(parent).legacy(), pobs);
+  EXPECT_EQ(context.trader_prefs(child).legacy(), cobs);
 
   child->Decommission();
   parent->Decommission();
@@ -173,13 +173,19 @@ class SimInitTest : public ::testing::TestWithParam<int> {
   cy::SimInfo siminfo(cy::Context* ctx) { return ctx->si_; }
   std::set<Agent*> agent_list(cy::Context* ctx) { return ctx->agent_list_; }
   std::map<int, cy::TimeListener*> tickers(cy::Timer* ti) { return ti->tickers_; }
+  void settime(cy::Timer* ti, int t) { ti->time_ = t; }
 
   std::map<int, std::vector<std::pair<std::string, Agent*> > >
   build_queue(cy::Timer* ti) {
     return ti->build_queue_;
   }
   std::map<int, std::vector<Agent*> > decom_queue(cy::Timer* ti) {
-    return ti->decom_queue_;
+    std::map<int, std::vector<Agent*> > queue;
+    std::map<int, std::list<Agent*> >::iterator it;
+    for (it = ti->decom_queue_.begin(); it != ti->decom_queue_.end(); ++it) {
+      queue[it->first].assign(it->second.begin(), it->second.end());
+    }
+    return queue;
   }
 
   cy::Context* ctx;
@@ -432,6 +438,85 @@ TEST_P(SimInitTest, InitAgentInventories) {
   }
 }
 
+TEST_P(SimInitTest, IncrementalSnapAgent) {
+  Inver* agent = NULL;
+  std::set<Agent*> agents = agent_list(ctx);
+  std::set<Agent*>::iterator it;
+  for (it = agents.begin(); it != agents.end(); ++it) {
+    if ((*it)->enter_time() != -1) {
+      agent = dynamic_cast<Inver*>(*it);
+      break;
+    }
+  }
+  ASSERT_TRUE(agent != NULL);
+
+  cy::SnapshotCache cache;
+  EXPECT_TRUE(cy::SimInit::SnapAgent(agent, &cache));
+  EXPECT_FALSE(cy::SimInit::SnapAgent(agent, &cache));
+
+  agent->val1 = 42;
+  EXPECT_TRUE(cy::SimInit::SnapAgent(agent, &cache));
+  EXPECT_FALSE(cy::SimInit::SnapAgent(agent, &cache));
+
+  cy::Material::Ptr m = agent->buf1.Pop();
+  EXPECT_TRUE(cy::SimInit::SnapAgent(agent, &cache));
+
+  cache.Clear();
+  EXPECT_TRUE(cy::SimInit::SnapAgent(agent, &cache));
+}
+
+TEST_P(SimInitTest, RestartIncremental) {
+  std::vector<Inver*> deployed;
+  std::set<Agent*> agents = agent_list(ctx);
+  std::set<Agent*>::iterator it;
+  for (it = agents.begin(); it != agents.end(); ++it) {
+    if ((*it)->enter_time() != -1) {
+      deployed.push_back(dynamic_cast<Inver*>(*it));
+    }
+  }
+  ASSERT_EQ(2, deployed.size());
+  Inver* same = deployed[0];
+  Inver* changed = deployed[1];
+
+  // every agent is recorded in the first incremental snapshot, and only the
+  // changed one in the second
+  cy::SnapshotCache cache;
+  same->val1 = 55;
+  settime(&ti, 1);
+  cy::SimInit::Snapshot(ctx, &cache);
+  changed->val1 = 99;
+  changed->buf1.Pop();
+  settime(&ti, 2);
+  cy::SimInit::Snapshot(ctx, &cache);
+  rec.Flush();
+
+  cy::PyStart();
+  cy::SimInit si;
+  si.Restart(b, rec.sim_id(), 2);
+  cy::PyStop();
+
+  std::map<int, Inver*> byid;
+  agents = agent_list(si.context());
+  for (it = agents.begin(); it != agents.end(); ++it) {
+    byid[(*it)->id()] = dynamic_cast<Inver*>(*it);
+  }
+
+  // the unchanged agent is restored from its snapshot at 1
+  ASSERT_EQ(1, byid.count(same->id()));
+  Inver* r = byid[same->id()];
+  EXPECT_EQ(55, r->val1);
+  EXPECT_EQ(1, r->buf1.count());
+  EXPECT_EQ(2, r->buf2.count());
+  EXPECT_DOUBLE_EQ(1, r->buf1.quantity());
+  EXPECT_DOUBLE_EQ(5, r->buf2.quantity());
+
+  ASSERT_EQ(1, byid.count(changed->id()));
+  r = byid[changed->id()];
+  EXPECT_EQ(99, r->val1);
+  EXPECT_EQ(0, r->buf1.count());
+  EXPECT_EQ(2, r->buf2.count());
+}
+
 TEST_P(SimInitTest, RestartSimInfo) {
   cy::PyStart();
   ti.RunSim();
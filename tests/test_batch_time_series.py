@@ -0,0 +1,49 @@
+import json
+import subprocess
+import os
+from tools import thread_count
+
+
+inputfile = {'simulation': {'archetypes': {'spec': [
+                                        {'lib': 'batch_time_series_recorder', 'name': 'BatchTimeSeriesRecorder'},
+                                        {'lib': 'agents', 'name': 'NullRegion'},
+                                        {'lib': 'agents', 'name': 'NullInst'}
+                                        ]},
+                'control': {'duration': '2',
+                            'startmonth': '1',
+                            'startyear': '2000'},
+                'facility': [{'config': {'BatchTimeSeriesRecorder': {}},
+                              'name': 'Recorder'}],
+                'region': {'config': {'NullRegion': None},
+                           'institution': {'config': {'NullInst': None},
+                                           'initialfacilitylist': {'entry': [{'number': '2',
+                                                                              'prototype': 'Recorder'}]},
+                                           'name': 'SingleInstitution'},
+                           'name': 'SingleRegion'}}}
+
+def test_batch_time_series(thread_count):
+    if os.path.exists('batch.h5'):
+        os.remove('batch.h5')
+    with open('batch.json', 'w') as f:
+        json.dump(inputfile, f)
+    env = dict(os.environ)
+    env['PYTHONPATH'] = "."
+    s = subprocess.check_output(['cyclus', '-j', thread_count, '-o', 'batch.h5', 'batch.json'], universal_newlines=True, env=env)
+    lines = [l for l in s.splitlines() if l.startswith(('BATCH', 'VALUE'))]
+
+    # the unlistened series never enters Python
+    assert not any('Unlistened' in l for l in lines)
+
+    # one batch per step with the values of both agents in recording order
+    batches = [l for l in lines if l.startswith('BATCH')]
+    assert batches == ['BATCH Listened 4', 'BATCH Listened 4']
+    values = [l.split()[1:] for l in lines if l.startswith('VALUE')]
+    assert len(values) == 8
+    ids = [v[1] for v in values[:4]]
+    assert ids[0] == ids[1] and ids[2] == ids[3] and int(ids[0]) < int(ids[2])
+    assert [v[2:] for v in values[:4]] == [['0', '0.0'], ['0', '0.0']] * 2
+    assert [v[2:] for v in values[4:]] == [['1', '1.0'], ['1', '10.0']] * 2
+    if os.path.exists('batch.json'):
+        os.remove('batch.json')
+    if os.path.exists('batch.h5'):
+        os.remove('batch.h5')
@@ -34,7 +34,8 @@ class TestTrader : public TestFacility {
         adjusts(0),
         requests(0),
         bids(0),
-        accept(0) {}
+        accept(0),
+        parallel_trades(false) {}
 
   virtual Agent* Clone() {
     TestTrader* m = new TestTrader(context());
@@ -51,6 +52,7 @@ class TestTrader : public TestFacility {
     offer = m->offer;
     obj_fac = m->obj_fac;
     is_requester = m->is_requester;
+    parallel_trades = m->parallel_trades;
     context()->RegisterTimeListener(this);
   }
 
@@ -86,6 +88,9 @@ class TestTrader : public TestFacility {
     }
   }
 
+  virtual bool ParallelTrades() { return parallel_trades; }
+
+  using TestFacility::AdjustMatlPrefs;
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {
     bid = (*prefs[req].begin()).first;  // obs bid
     adjusts++;
@@ -122,6 +127,7 @@ class TestTrader : public TestFacility {
   Material::Ptr mat;  // obs mat
   bool is_requester;
   int accept, offer, requests, bids, adjusts;
+  bool parallel_trades;
 };
 
 }  // namespace cyclus
@@ -0,0 +1,115 @@
+#include "platform.h"
+#if CYCLUS_IS_PARALLEL
+#include <omp.h>
+#endif  // CYCLUS_IS_PARALLEL
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "error.h"
+#include "tick_scheduler.h"
+#include "time_listener.h"
+
+using cyclus::TickScheduler;
+using cyclus::TimeListener;
+
+// records the order of its ticks in a shared log, and sleeps for a while on
+// each tick
+class LoggingListener : public TimeListener {
+ public:
+  LoggingListener(int id, int sleep_ms, std::vector<int>* log)
+      : id_(id), sleep_ms_(sleep_ms), log_(log) {}
+
+  virtual const int id() const { return id_; }
+  virtual bool IsShim() { return false; }
+
+  virtual void Tick() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+#pragma omp critical
+    log_->push_back(id_);
+  }
+  virtual void Tock() {}
+
+ private:
+  int id_;
+  int sleep_ms_;
+  std::vector<int>* log_;
+};
+
+TEST(TickSchedulerTests, ParsePolicy) {
+  EXPECT_EQ(TickScheduler::STATIC, TickScheduler::ParsePolicy("static"));
+  EXPECT_EQ(TickScheduler::COST, TickScheduler::ParsePolicy("cost"));
+  EXPECT_THROW(TickScheduler::ParsePolicy("fastest"), cyclus::ValueError);
+}
+
+TEST(TickSchedulerTests, CostOrder) {
+#if CYCLUS_IS_PARALLEL
+  int nthreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif  // CYCLUS_IS_PARALLEL
+  std::vector<int> log;
+  LoggingListener cheap(1, 0, &log);
+  LoggingListener dear(2, 20, &log);
+  std::vector<TimeListener*> listeners;
+  listeners.push_back(&cheap);
+  listeners.push_back(&dear);
+
+  TickScheduler sched(TickScheduler::COST);
+  EXPECT_LT(sched.cost(&dear), 0);
+  sched.Run(listeners, &TimeListener::Tick);
+  ASSERT_EQ(2, log.size());
+  EXPECT_EQ(1, log[0]);
+  EXPECT_EQ(2, log[1]);
+  EXPECT_GT(sched.cost(&dear), sched.cost(&cheap));
+
+  // the expensive listener goes first once measured
+  log.clear();
+  sched.Run(listeners, &TimeListener::Tick);
+  ASSERT_EQ(2, log.size());
+  EXPECT_EQ(2, log[0]);
+  EXPECT_EQ(1, log[1]);
+
+  sched.Forget(&dear);
+  EXPECT_LT(sched.cost(&dear), 0);
+  EXPECT_GE(sched.cost(&cheap), 0);
+#if CYCLUS_IS_PARALLEL
+  omp_set_num_threads(nthreads);
+#endif  // CYCLUS_IS_PARALLEL
+}
+
+TEST(TickSchedulerTests, CallsEachListenerOnce) {
+  std::vector<int> log;
+  std::vector<LoggingListener*> owned;
+  std::vector<TimeListener*> listeners;
+  for (int i = 0; i < 50; ++i) {
+    owned.push_back(new LoggingListener(i, i % 10 == 0 ? 2 : 0, &log));
+    listeners.push_back(owned.back());
+  }
+
+  TickScheduler stat(TickScheduler::STATIC);
+  TickScheduler cost(TickScheduler::COST);
+  for (int step = 0; step < 3; ++step) {
+    log.clear();
+    stat.Run(listeners, &TimeListener::Tick);
+    std::sort(log.begin(), log.end());
+    ASSERT_EQ(50, log.size());
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_EQ(i, log[i]);
+    }
+
+    log.clear();
+    cost.Run(listeners, &TimeListener::Tick);
+    std::sort(log.begin(), log.end());
+    ASSERT_EQ(50, log.size());
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_EQ(i, log[i]);
+    }
+  }
+
+  for (int i = 0; i < owned.size(); ++i) {
+    delete owned[i];
+  }
+}
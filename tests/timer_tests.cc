@@ -42,6 +42,13 @@ class Dier : public cyclus::Facility {
 
 int Dier::decom_count = 0;
 
+/// A Dier that does not schedule its own decommissioning.
+class Lingerer : public Dier {
+ public:
+  Lingerer(cyclus::Context* ctx) : Dier(ctx) {}
+  void Tick() {}
+};
+
 class Termer : public cyclus::Facility {
  public:
   Termer(cyclus::Context* ctx) : cyclus::Facility(ctx) {}
@@ -101,6 +108,80 @@ class SnapperDec : public cyclus::Facility {
   bool snap;
 };
 
+class Sleeper : public cyclus::Facility {
+ public:
+  Sleeper(cyclus::Context* ctx)
+      : cyclus::Facility(ctx), ticks(0), tocks(0), decisions(0) {}
+  virtual ~Sleeper() {}
+
+  virtual cyclus::Agent* Clone() { return new Sleeper(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  void Tick() {
+    ticks++;
+    context()->SleepUntil(this, context()->time() + 3);
+  }
+  void Tock() { tocks++; }
+  void Decision() { decisions++; }
+  int ticks;
+  int tocks;
+  int decisions;
+};
+
+/// Holds one material to start with and receives a second one at time 5.
+/// Its inventory is emptied at time 7 and refilled with the same materials at
+/// time 9.
+class Holder : public cyclus::Facility {
+ public:
+  Holder(cyclus::Context* ctx) : cyclus::Facility(ctx) {
+    cyclus::CompMap v;
+    v[922350000] = 1;
+    v[922380000] = 3;
+    comp = cyclus::Composition::CreateFromMass(v);
+    inv.push_back(cyclus::Material::CreateUntracked(4, comp));
+  }
+  virtual ~Holder() {}
+
+  virtual cyclus::Agent* Clone() { return new Holder(context()); }
+  virtual void InitInv(cyclus::Inventories& invs) {}
+  virtual cyclus::Inventories SnapshotInv() {
+    cyclus::Inventories invs;
+    invs["inv"] = inv;
+    return invs;
+  }
+
+  void Tick() {
+    if (context()->time() == 5) {
+      inv.push_back(cyclus::Material::CreateUntracked(4, comp));
+    } else if (context()->time() == 7) {
+      inv.swap(drained);
+    } else if (context()->time() == 9) {
+      inv.swap(drained);
+    }
+  }
+  void Tock() {}
+  void Decision() {}
+  cyclus::Composition::Ptr comp;
+  std::vector<cyclus::Resource::Ptr> inv;
+  std::vector<cyclus::Resource::Ptr> drained;
+};
+
+/// Decides concurrently to be decommissioned at time 1.
+class ParallelDecider : public Dier {
+ public:
+  ParallelDecider(cyclus::Context* ctx) : Dier(ctx), decisions(0) {}
+  void Tick() {}
+  void Decision() {
+    decisions++;
+    if (context()->time() == 0) {
+      context()->SchedDecom(this, 1);
+    }
+  }
+  virtual bool ParallelDecision() { return true; }
+  int decisions;
+};
+
 class TimerTestsFixture : public ::testing::TestWithParam<int> {
   protected:
     #if CYCLUS_IS_PARALLEL
@@ -344,6 +425,199 @@ TEST_P(TimerTestsFixture, DoubleDecom) {
   cyclus::PyStop();
 }
 
+TEST_P(TimerTestsFixture, RescheduleDecom) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(4));
+
+  Lingerer* d1 = new Lingerer(&ctx);
+  d1->Build(NULL);
+  Lingerer* d2 = new Lingerer(&ctx);
+  d2->Build(NULL);
+  ctx.SchedDecom(d1, 1);
+  ctx.SchedDecom(d2, 1);
+  ctx.SchedDecom(d1, 2);
+  ctx.SchedDecom(d1, 5);
+
+  Dier::decom_count = 0;
+  ti.RunSim();
+  EXPECT_EQ(1, Dier::decom_count);
+  cyclus::PyStop();
+}
+
+TEST_P(TimerTestsFixture, SleepUntil) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(10));
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->Build(NULL);
+
+  // falls asleep during tick and wakes at 3, 6 and 9
+  ti.RunSim();
+  EXPECT_EQ(4, s->ticks);
+  EXPECT_EQ(0, s->tocks);
+  EXPECT_EQ(0, s->decisions);
+  EXPECT_TRUE(ctx.IsAsleep(s));
+
+  ctx.Wake(s);
+  EXPECT_FALSE(ctx.IsAsleep(s));
+  ctx.SleepUntil(s, 0);
+  EXPECT_FALSE(ctx.IsAsleep(s));
+  cyclus::PyStop();
+}
+
+TEST_P(TimerTestsFixture, SkipIdleSteps) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(10));
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->Build(NULL);
+  ctx.SchedDecom(s, 7);
+
+  ti.RunSim();
+  rec.Close();
+
+  // asleep from 1 to 2 and from 4 to 5, decommissioned at 7
+  cyclus::QueryResult qr = b.Query("SkippedSteps", NULL);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("StartTime", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("EndTime", 0));
+  EXPECT_EQ(4, qr.GetVal<int>("StartTime", 1));
+  EXPECT_EQ(5, qr.GetVal<int>("EndTime", 1));
+  EXPECT_EQ(8, qr.GetVal<int>("StartTime", 2));
+  EXPECT_EQ(9, qr.GetVal<int>("EndTime", 2));
+
+  qr = b.Query("Finish", NULL);
+  EXPECT_EQ(9, qr.GetVal<int>("EndTime"));
+  cyclus::PyStop();
+}
+
+TEST_P(TimerTestsFixture, SkipIdleStepsInventory) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(10);
+  si.explicit_inventory = true;
+  si.explicit_inventory_interval = 2;
+  ti.Initialize(&ctx, si);
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  // awake at 0, 3, 6 and 9, and inventories are recorded at even steps
+  cyclus::QueryResult qr = b.Query("SkippedSteps", NULL);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("StartTime", 0));
+  EXPECT_EQ(1, qr.GetVal<int>("EndTime", 0));
+  EXPECT_EQ(5, qr.GetVal<int>("StartTime", 1));
+  EXPECT_EQ(5, qr.GetVal<int>("EndTime", 1));
+  EXPECT_EQ(7, qr.GetVal<int>("StartTime", 2));
+  EXPECT_EQ(7, qr.GetVal<int>("EndTime", 2));
+  cyclus::PyStop();
+}
+
+TEST_P(TimerTestsFixture, ParallelDecision) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+
+  Dier::decom_count = 0;
+  std::vector<ParallelDecider*> deciders;
+  for (int i = 0; i < 8; ++i) {
+    deciders.push_back(new ParallelDecider(&ctx));
+    deciders.back()->Build(NULL);
+  }
+
+  ti.RunSim();
+  rec.Close();
+
+  for (int i = 0; i < deciders.size(); ++i) {
+    EXPECT_EQ(3, deciders[i]->decisions);
+  }
+  EXPECT_EQ(8, Dier::decom_count);
+
+  // deferred decommissionings are scheduled in id order
+  cyclus::QueryResult qr = b.Query("DecomSchedule", NULL);
+  ASSERT_EQ(8, qr.rows.size());
+  for (int i = 0; i < deciders.size(); ++i) {
+    EXPECT_EQ(deciders[i]->id(), qr.GetVal<int>("AgentId", i));
+  }
+  cyclus::PyStop();
+}
+
+TEST_P(TimerTestsFixture, IncrementalInventory) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(12);
+  si.explicit_inventory = true;
+  si.explicit_inventory_compact = true;
+  si.explicit_inventory_interval = 2;
+  si.explicit_inventory_incremental = true;
+  ti.Initialize(&ctx, si);
+
+  Holder* h = new Holder(&ctx);
+  h->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  // recorded at 0, again at 6 after the inventory grew at 5, empty at 8
+  // after it was drained at 7 and full at 10 after it was refilled at 9
+  cyclus::QueryResult qr = b.Query("ExplicitInventoryCompact", NULL);
+  ASSERT_EQ(4, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_DOUBLE_EQ(4, qr.GetVal<double>("Quantity", 0));
+  EXPECT_EQ(6, qr.GetVal<int>("Time", 1));
+  EXPECT_DOUBLE_EQ(8, qr.GetVal<double>("Quantity", 1));
+  cyclus::CompMap c = qr.GetVal<cyclus::CompMap>("Composition", 1);
+  EXPECT_DOUBLE_EQ(0.25, c[922350000]);
+  EXPECT_EQ(8, qr.GetVal<int>("Time", 2));
+  EXPECT_DOUBLE_EQ(0, qr.GetVal<double>("Quantity", 2));
+  EXPECT_EQ(10, qr.GetVal<int>("Time", 3));
+  EXPECT_DOUBLE_EQ(8, qr.GetVal<double>("Quantity", 3));
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("NucId", "==", 922380000));
+  qr = b.Query("ExplicitInventory", &conds);
+  ASSERT_EQ(4, qr.rows.size());
+  EXPECT_DOUBLE_EQ(3, qr.GetVal<double>("Quantity", 0));
+  EXPECT_DOUBLE_EQ(6, qr.GetVal<double>("Quantity", 1));
+  EXPECT_EQ(8, qr.GetVal<int>("Time", 2));
+  EXPECT_DOUBLE_EQ(0, qr.GetVal<double>("Quantity", 2));
+  EXPECT_DOUBLE_EQ(6, qr.GetVal<double>("Quantity", 3));
+  cyclus::PyStop();
+}
+
 #if CYCLUS_IS_PARALLEL
 INSTANTIATE_TEST_CASE_P(TimerTestsParallel, TimerTestsFixture, ::testing::Values(1, 2, 3, 4));
 #else
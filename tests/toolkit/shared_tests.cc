@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "toolkit/shared.h"
+
+using cyclus::toolkit::Shared;
+
+TEST(SharedTests, Default) {
+  Shared<std::vector<int> > a;
+  EXPECT_TRUE(a->empty());
+  EXPECT_TRUE(a.unique());
+
+  a.mut().push_back(1);
+  EXPECT_EQ(1, a->size());
+}
+
+TEST(SharedTests, CopyOnWrite) {
+  std::vector<std::string> v;
+  v.push_back("uox");
+  Shared<std::vector<std::string> > proto = v;
+  Shared<std::vector<std::string> > clone = proto;
+
+  EXPECT_EQ(&proto.get(), &clone.get());
+  EXPECT_FALSE(clone.unique());
+
+  clone.mut().push_back("mox");
+  EXPECT_NE(&proto.get(), &clone.get());
+  EXPECT_TRUE(proto.unique());
+  EXPECT_EQ(1, proto->size());
+  EXPECT_EQ(2, clone->size());
+
+  // modifying an unshared value does not copy it
+  const std::vector<std::string>* before = &clone.get();
+  clone.mut().push_back("fr");
+  EXPECT_EQ(before, &clone.get());
+}
+
+TEST(SharedTests, Assign) {
+  std::map<std::string, double> m;
+  m["x"] = 1;
+  Shared<std::map<std::string, double> > a = m;
+  Shared<std::map<std::string, double> > b = a;
+
+  m["x"] = 2;
+  b = m;
+  EXPECT_DOUBLE_EQ(1, a->at("x"));
+  EXPECT_DOUBLE_EQ(2, (*b).at("x"));
+
+  const std::map<std::string, double>& ref = b;
+  EXPECT_EQ(1, ref.size());
+}
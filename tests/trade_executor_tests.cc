@@ -212,6 +212,33 @@ TEST_F(TradeExecutorTests, WholeShebang) {
   EXPECT_EQ(r2->accept, 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(TradeExecutorTests, ParallelWholeShebang) {
+  // only some of the traders may be called concurrently
+  s2->parallel_trades = true;
+  r1->parallel_trades = true;
+  TradeExecutor<Material> exec(trades, true);
+  exec.ExecuteTrades();
+  EXPECT_EQ(s1->offer, 1);
+  EXPECT_EQ(s1->accept, 0);
+  EXPECT_EQ(s2->offer, 2);
+  EXPECT_EQ(s2->accept, 0);
+  EXPECT_EQ(r1->offer, 0);
+  EXPECT_EQ(r1->accept, 2);
+  EXPECT_EQ(r2->offer, 0);
+  EXPECT_EQ(r2->accept, 1);
+
+  // responses are grouped as in serial execution
+  TradeExecutor<Material> serial(trades);
+  serial.ExecuteTrades();
+  EXPECT_EQ(serial.trade_ctx().all_trades.size(),
+            exec.trade_ctx().all_trades.size());
+  EXPECT_EQ(serial.trade_ctx().trades_by_requester[r1],
+            exec.trade_ctx().trades_by_requester[r1]);
+  EXPECT_EQ(serial.trade_ctx().trades_by_requester[r2],
+            exec.trade_ctx().trades_by_requester[r2]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(TradeExecutorTests, NoThrowWriting) {
   TradeExecutor<Material> exec(trades);
@@ -317,7 +344,7 @@ TEST_F(TradeExecutorDatabaseTests, ExchangeContextWithAdjustedPreferences) {
   double adj_pref = 4.2;
   
   // change the preference manually to new value
-  ex_ctx.trader_prefs[r1_][req][bid] = adj_pref;
+  ex_ctx.prefs[bid->id()] = adj_pref;
   
   TradeExecutor<Material> exec(trades);
   
@@ -329,7 +356,7 @@ TEST_F(TradeExecutorDatabaseTests, ExchangeContextWithAdjustedPreferences) {
   EXPECT_DOUBLE_EQ(bid->preference(), orig_pref);
   
   // Verify adjusted preference in ExchangeContext
-  EXPECT_DOUBLE_EQ(ex_ctx.trader_prefs[r1_][req][bid], adj_pref);
+  EXPECT_DOUBLE_EQ(ex_ctx.prefs[bid->id()], adj_pref);
   
   // Query database and verify different original vs adjusted preferences
   cyclus::QueryResult qr = backend_->Query("Transactions", NULL);
@@ -5,6 +5,8 @@
 #include <sstream>
 #include <string>
 
+#include <boost/filesystem.hpp>
+
 #include "agent.h"
 #include "dynamic_module.h"
 #include "env.h"
@@ -293,3 +295,38 @@ TEST_F(XMLFileLoaderTests, ExplicitFormat) {
 TEST_F(XMLFileLoaderTests, throws) {
   EXPECT_THROW(XMLFileLoader file(&rec_, b_, schema_path, "blah"), cyclus::IOError);
 }
+
+TEST_F(XMLFileLoaderTests, CachedMasterSchema) {
+  namespace fs = boost::filesystem;
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  setenv("CYCLUS_SCHEMA_CACHE", dir.string().c_str(), 1);
+
+  std::vector<cyclus::AgentSpec> specs;
+  specs.push_back(cyclus::AgentSpec("tests:TestFacility:TestFacility"));
+  std::string master = cyclus::BuildMasterSchema(schema_path, specs);
+  EXPECT_NE(std::string::npos, master.find("<element name=\"TestFacility\">"));
+
+  // the second build is read from the cache
+  ASSERT_EQ(1, std::distance(fs::directory_iterator(dir),
+                             fs::directory_iterator()));
+  fs::path cached = fs::directory_iterator(dir)->path();
+  std::stringstream ss;
+  cyclus::LoadRawStringstreamFromFile(ss, cached.string());
+  std::string content = ss.str();
+  ASSERT_EQ(master, content.substr(content.size() - master.size()));
+  std::string key = content.substr(0, content.size() - master.size());
+  std::ofstream f(cached.string().c_str());
+  f << key << "cached";
+  f.close();
+  EXPECT_EQ("cached", cyclus::BuildMasterSchema(schema_path, specs));
+
+  // a cached schema with another key is rebuilt
+  f.open(cached.string().c_str());
+  f << "5\nother" << "cached";
+  f.close();
+  EXPECT_EQ(master, cyclus::BuildMasterSchema(schema_path, specs));
+
+  unsetenv("CYCLUS_SCHEMA_CACHE");
+  EXPECT_EQ(master, cyclus::BuildMasterSchema(schema_path, specs));
+  fs::remove_all(dir);
+}